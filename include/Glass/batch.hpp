@@ -0,0 +1,193 @@
+#pragma once
+
+// Dependencies
+#include "typedef.hpp"
+
+namespace gs {
+	class Component;
+
+	///////////////////////////////////////////////////////////
+	/// class RenderBatch collects the geometry of many
+	/// Components into shared vertex arrays grouped by texture
+	/// and blend mode so that a whole Menu can be rendered in a
+	/// handful of draw calls. Components that can't express
+	/// themselves as plain triangles are recorded in order and
+	/// rendered normally when the batch is drawn.
+	///////////////////////////////////////////////////////////
+	class GLASS_EXPORT RenderBatch {
+	public:
+		RenderBatch();
+		~RenderBatch();
+
+		///////////////////////////////////////////////////////////
+		/// Method clear() will remove all of the recorded
+		/// geometry. Note: The memory used by the vertex arrays is
+		/// kept so the next frame doesn't need to reallocate it.
+		///////////////////////////////////////////////////////////
+		void clear();
+		///////////////////////////////////////////////////////////
+		/// Method draw() will render all of the recorded geometry
+		/// to a sf::RenderTarget.
+		/// @param sf::RenderTarget* target: Pointer to the target
+		///  you want to render. Example: &window.
+		/// @param sf::RenderStates: Transform and shader used for
+		///  every draw call. The texture and blend mode are
+		///  replaced by the ones of each batch.
+		///////////////////////////////////////////////////////////
+		void draw(
+			sf::RenderTarget* target,
+			sf::RenderStates renderStates = sf::RenderStates::Default
+		);
+
+		///////////////////////////////////////////////////////////
+		/// Method addTriangles() will reserve space for a number
+		/// of vertices inside of the batch matching the texture
+		/// and blend mode given.
+		/// @param size_t vertexCount: Number of vertices. Must be
+		///  a multiple of 3.
+		/// @param sf::FloatRect bounds: Area covered by the new
+		///  vertices.
+		/// @param const sf::Texture* texture: Texture used by the
+		///  vertices or nullptr if untextured.
+		/// @param sf::BlendMode blendMode: Blend mode of vertices.
+		/// @returns sf::Vertex*: Pointer to the first reserved
+		///  vertex. Note: It is only valid until the next call
+		///  to the batch.
+		///////////////////////////////////////////////////////////
+		sf::Vertex* addTriangles(
+			size_t vertexCount, sf::FloatRect bounds,
+			const sf::Texture* texture = nullptr,
+			sf::BlendMode blendMode = sf::BlendAlpha
+		);
+		///////////////////////////////////////////////////////////
+		/// Method addRectangle() will add a filled rectangle to
+		/// the batch.
+		/// @param Vec2f position: Top left corner of rectangle.
+		/// @param Vec2f size: Size of rectangle.
+		/// @param Color color: Fill color.
+		/// @param float outlineThickness: Thickness of the outline
+		///  drawn outside of the rectangle.
+		/// @param Color outlineColor: Color of the outline.
+		///////////////////////////////////////////////////////////
+		void addRectangle(
+			Vec2f position, Vec2f size, Color color,
+			float outlineThickness = 0.0f, Color outlineColor = Color::Black
+		);
+		///////////////////////////////////////////////////////////
+		/// Method addCircle() will add a filled circle to the
+		/// batch.
+		/// @param Vec2f position: Top left corner of the circles
+		///  bounding box. Same as sf::CircleShape.
+		/// @param float radius: Radius of circle.
+		/// @param Color color: Fill color.
+		/// @param float outlineThickness: Thickness of the outline
+		///  drawn outside of the circle.
+		/// @param Color outlineColor: Color of the outline.
+		/// @param size_t pointCount: Number of points around the
+		///  edge of the circle.
+		///////////////////////////////////////////////////////////
+		void addCircle(
+			Vec2f position, float radius, Color color,
+			float outlineThickness = 0.0f, Color outlineColor = Color::Black,
+			size_t pointCount = 30
+		);
+		///////////////////////////////////////////////////////////
+		/// Method addSprite() will add a textured quad matching a
+		/// sf::Sprite to the batch.
+		/// @param const sf::Sprite& sprite: Sprite to add.
+		/// @param Color color: Color to modulate the texture by.
+		/// @param sf::BlendMode blendMode: Blend mode of quad.
+		///////////////////////////////////////////////////////////
+		void addSprite(
+			const sf::Sprite& sprite, Color color,
+			sf::BlendMode blendMode = sf::BlendAlpha
+		);
+		///////////////////////////////////////////////////////////
+		/// Method addDrawable() will record a sf::Drawable that
+		/// should be drawn in order with the rest of the batch.
+		/// Note: The drawable must stay alive until draw() is
+		/// called.
+		/// @param const sf::Drawable& drawable: Drawable object.
+		/// @param sf::FloatRect bounds: Area covered by drawable.
+		///////////////////////////////////////////////////////////
+		void addDrawable(const sf::Drawable& drawable, sf::FloatRect bounds);
+		///////////////////////////////////////////////////////////
+		/// Method addComponent() will record a Component that
+		/// can't be batched. Its render() method will be called
+		/// in order with the rest of the batch.
+		/// @param Component* component: Pointer to Component.
+		///////////////////////////////////////////////////////////
+		void addComponent(Component* component);
+
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of draw calls issued by the
+		///  last call to draw(). Note: Components recorded with
+		///  addComponent() aren't counted since their render()
+		///  can make any number of draw calls.
+		///////////////////////////////////////////////////////////
+		size_t getDrawCallCount() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of Components rendered
+		///  normally by the last call to draw().
+		///////////////////////////////////////////////////////////
+		size_t getFallbackCount() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of vertices currently recorded.
+		///////////////////////////////////////////////////////////
+		size_t getVertexCount() const;
+	protected:
+		///////////////////////////////////////////////////////////
+		/// struct Command is a private struct describing one draw
+		/// call of the batch.
+		///////////////////////////////////////////////////////////
+		struct Command {
+			/// What the Command draws.
+			enum class Type { Triangles, Drawable, Component }
+				type = Type::Triangles;
+			/// Texture of batched triangles.
+			const sf::Texture* texture = nullptr;
+			/// Blend mode of batched triangles.
+			sf::BlendMode blendMode = sf::BlendAlpha;
+			/// Batched triangles.
+			vector<sf::Vertex> vertices;
+			/// Recorded drawable object.
+			const sf::Drawable* drawable = nullptr;
+			/// Recorded Component object.
+			Component* component = nullptr;
+			/// Area covered by everything in the Command.
+			sf::FloatRect bounds;
+			/// Set to true when the bounds are unknown.
+			bool opaqueBounds = false;
+		};
+		/// Commands in draw order. Note: Only the first commandCount are used.
+		vector<Command> commands;
+		/// Number of Commands in use this frame.
+		size_t commandCount = 0;
+		/// Number of draw calls made by the last draw() call.
+		size_t drawCallCount = 0;
+		/// Number of Components rendered by the last draw() call.
+		size_t fallbackCount = 0;
+
+		///////////////////////////////////////////////////////////
+		/// Method findCommand() will return a Command that new
+		/// triangles can be merged into without changing what
+		/// ends up on screen. If none can be found a new one is
+		/// started.
+		/// @param sf::FloatRect bounds: Area of new triangles.
+		/// @param const sf::Texture* texture: Texture used.
+		/// @param sf::BlendMode blendMode: Blend mode used.
+		/// @returns Command&: Command to append the triangles to.
+		///////////////////////////////////////////////////////////
+		Command& findCommand(
+			sf::FloatRect bounds, const sf::Texture* texture,
+			sf::BlendMode blendMode
+		);
+		///////////////////////////////////////////////////////////
+		/// Method nextCommand() will return an unused Command
+		/// reusing old memory when possible.
+		/// @param Command::Type type: Type of the Command.
+		/// @returns Command&: Reset Command.
+		///////////////////////////////////////////////////////////
+		Command& nextCommand(Command::Type type);
+	};
+}
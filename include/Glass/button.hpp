@@ -75,6 +75,12 @@ namespace gs {
 			sf::RenderTarget* target,
 			sf::RenderStates renderStates = sf::RenderStates::Default
 		) override;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add the Button geometry to a 
+		/// RenderBatch. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch) override;
 
 		///////////////////////////////////////////////////////////
 		/// Method clearShapeColors() will set all of the color 
@@ -246,6 +252,20 @@ namespace gs {
 		///////////////////////////////////////////////////////////  
 		virtual void setString(const std::string& string);
 		///////////////////////////////////////////////////////////
+		/// Method insertString() will insert characters into the 
+		/// string of the internal Text object. 
+		/// @param size_t position: Index to insert at. 
+		/// @param const std::string& string: Characters to insert. 
+		///////////////////////////////////////////////////////////  
+		virtual void insertString(size_t position, const std::string& string);
+		///////////////////////////////////////////////////////////
+		/// Method eraseString() will remove characters from the 
+		/// string of the internal Text object. 
+		/// @param size_t position: Index of first character. 
+		/// @param size_t count: Number of characters. 
+		///////////////////////////////////////////////////////////  
+		virtual void eraseString(size_t position, size_t count);
+		///////////////////////////////////////////////////////////
 		/// Method setTextOffset() will change the position of the 
 		/// Text from its origin. Note: By default it is set to 
 		/// (0, 0) meaning it wont offset the text. 
@@ -442,6 +462,19 @@ namespace gs {
 		/// @returns bool: Returns if Button is locked or not. 
 		/////////////////////////////////////////////////////////// 
 		virtual bool isLocked() const override;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if the Button reacts to the mouse. 
+		///////////////////////////////////////////////////////////
+		virtual bool acceptsPointer() const override;
+		///////////////////////////////////////////////////////////
+		/// Method updatePointer() will update isSelected and 
+		/// isClickedOn depending on if the mouse is over the 
+		/// Button. This is called by Menu or by update() if the
+		/// Button isn't in a Menu. 
+		/// @param bool hovered: True if the mouse is over the 
+		///  Button. 
+		///////////////////////////////////////////////////////////
+		virtual void updatePointer(bool hovered) override;
 
 		///////////////////////////////////////////////////////////
 		/// @returns Vec2f: Size of Button. Note: If using a
@@ -3,8 +3,12 @@
 // Dependencies 
 #include "hitbox.hpp"
 #include "style.hpp"
+#include "batch.hpp"
+#include "spatialGrid.hpp"
 
 namespace gs {
+	class Menu;
+
 	///////////////////////////////////////////////////////////
 	/// class Component is an abstract class for defining basic
 	/// UI elements in Glass. Alot of classes in Glass inherit
@@ -14,8 +18,18 @@ namespace gs {
 	///////////////////////////////////////////////////////////
 	class GLASS_EXPORT Component {
 	public: 
-		/// Offset of subclass from the Menu when using the Menu class. 
-		Vec2f menuOffset;
+		/// Parts of a subclass that can change between frames. Used to skip
+		/// work when nothing has changed. 
+		enum class Dirty {
+			None = 0,
+			Transform = 1 << 0,
+			Geometry = 1 << 1,
+			Style = 1 << 2,
+			Hitbox = 1 << 3,
+			World = 1 << 4,
+			Visual = Transform | Geometry | Style,
+			All = Visual | Hitbox | World
+		};
 
 		Component() = default; 
 		~Component() = default;
@@ -39,6 +53,41 @@ namespace gs {
 			sf::RenderTarget* target,
 			sf::RenderStates renderStates = sf::RenderStates::Default
 		) = 0;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add the geometry of the subclass to
+		/// a RenderBatch instead of drawing it directly. This is 
+		/// used by Menu when its renderMethod is set to Batched. 
+		/// By default the subclass is recorded as is and rendered 
+		/// with render() when the batch is drawn. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch);
+		///////////////////////////////////////////////////////////
+		/// Method acceptsPointer() is used by Menu to know if the 
+		/// subclass wants to be told when the mouse is over it. 
+		/// @returns bool: True if updatePointer() should be 
+		///  called. False by default. 
+		///////////////////////////////////////////////////////////
+		virtual bool acceptsPointer() const;
+		///////////////////////////////////////////////////////////
+		/// Method updatePointer() is called by Menu before 
+		/// update() with the result of its hit test so that the 
+		/// subclass doesn't need to test the mouse itself. It is 
+		/// only called while the mouse is over the subclass and 
+		/// once more with false when it leaves. 
+		/// @param bool hovered: True if the mouse is over the 
+		///  subclass. 
+		///////////////////////////////////////////////////////////
+		virtual void updatePointer(bool hovered);
+		///////////////////////////////////////////////////////////
+		/// Method isUpdateThreadSafe() is used by Menu to know if 
+		/// update() can run on another thread at the same time as
+		/// the update() of other Components. It should only 
+		/// return true if update() doesn't touch anything shared 
+		/// like fonts, textures or other Components. 
+		/// @returns bool: False by default. 
+		///////////////////////////////////////////////////////////
+		virtual bool isUpdateThreadSafe() const;
 
 		///////////////////////////////////////////////////////////
 		/// Method setPosition() will set the position of the 
@@ -120,13 +169,123 @@ namespace gs {
 		/// @returns bool: Returns if subclass is locked or not. 
 		///////////////////////////////////////////////////////////            
 		virtual bool isLocked() const = 0;
+
+		///////////////////////////////////////////////////////////
+		/// Method getLocalTransform() will return the transform 
+		/// the subclass applies to the Components inside of it. 
+		/// Example: A Menu offsets its Components by its 
+		/// position. 
+		/// @returns sf::Transform: Identity by default. 
+		///////////////////////////////////////////////////////////  
+		virtual sf::Transform getLocalTransform() const;
+		///////////////////////////////////////////////////////////
+		/// Method getWorldTransform() will return the transform 
+		/// from the space inside of the subclass to the world by
+		/// combining the local transforms of all of its parents. 
+		/// It is cached and only recomputed after the subclass or
+		/// one of its parents moved. 
+		/// @returns const sf::Transform&: World transform. 
+		///////////////////////////////////////////////////////////  
+		const sf::Transform& getWorldTransform() const;
+		///////////////////////////////////////////////////////////
+		/// @returns Menu*: Menu the subclass was added to or 
+		///  nullptr if none. 
+		///////////////////////////////////////////////////////////  
+		Menu* getParent() const;
+
+		///////////////////////////////////////////////////////////
+		/// Method setZIndex() will change where the subclass is 
+		/// drawn inside of its layer. Higher values are drawn on 
+		/// top and are hit by the mouse first. Components with 
+		/// the same value keep the order they were added in. 
+		/// @param int zIndex: New z-index. 0 by default. 
+		///////////////////////////////////////////////////////////  
+		void setZIndex(int zIndex);
+		///////////////////////////////////////////////////////////
+		/// @returns int: Z-index of subclass. 
+		///////////////////////////////////////////////////////////  
+		int getZIndex() const;
+		///////////////////////////////////////////////////////////
+		/// Method setLayer() will move the subclass to another 
+		/// layer. Every Component of a higher layer is drawn on 
+		/// top of every Component of a lower layer no matter 
+		/// their z-index. Example: A layer for popups. 
+		/// @param unsigned int layer: New layer. 0 by default. 
+		///////////////////////////////////////////////////////////  
+		void setLayer(unsigned int layer);
+		///////////////////////////////////////////////////////////
+		/// @returns unsigned int: Layer of subclass. 
+		///////////////////////////////////////////////////////////  
+		unsigned int getLayer() const;
+
+		///////////////////////////////////////////////////////////
+		/// Method markDirty() will flag parts of the subclass as 
+		/// changed. 
+		/// @param Dirty flags: Parts that changed. 
+		///////////////////////////////////////////////////////////  
+		void markDirty(Dirty flags);
+		///////////////////////////////////////////////////////////
+		/// Method clearDirty() will remove flags set by 
+		/// markDirty(). 
+		/// @param Dirty flags: Parts to clear. 
+		///////////////////////////////////////////////////////////  
+		void clearDirty(Dirty flags) const;
+		///////////////////////////////////////////////////////////
+		/// @param Dirty flags: Parts to check. 
+		/// @returns bool: True if any of the parts given are 
+		///  flagged as changed. 
+		///////////////////////////////////////////////////////////  
+		bool isDirty(Dirty flags = Dirty::All) const;
+		///////////////////////////////////////////////////////////
+		/// Method hasChanged() will check if the subclass looks 
+		/// different since it was last rendered by a Menu. 
+		/// @returns bool: True if it needs to be redrawn. 
+		///////////////////////////////////////////////////////////  
+		virtual bool hasChanged() const;
+		///////////////////////////////////////////////////////////
+		/// Method setPointerRouted() will tell the subclass if 
+		/// something else calls updatePointer() for it. If not 
+		/// the subclass tests the mouse itself in update(). 
+		/// @param bool routed: True if updatePointer() is called
+		///  for the subclass. 
+		///////////////////////////////////////////////////////////  
+		void setPointerRouted(bool routed);
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if something else calls 
+		///  updatePointer() for the subclass. 
+		///////////////////////////////////////////////////////////  
+		bool isPointerRouted() const;
 	protected:
-		/// Underlying general shape of subclass. 
-		Hitbox hitbox;
+		/// Underlying general shape of subclass. Mutable so it can be 
+		/// regenerated lazily from const getters. 
+		mutable Hitbox hitbox;
 		/// Visual representation of subclass. 
 		Style style; 
 		/// Is true when object shouldn't update. 
 		bool locked;
+		/// Dirty flags of parts that changed. Everything starts dirty. 
+		mutable unsigned int dirtyFlags = static_cast<unsigned int>(Dirty::All);
+		/// Index of the Menu this subclass is in. Told when the Hitbox may 
+		/// have moved. 
+		priv::SpatialGrid* spatialIndex = nullptr;
+		/// True when a Menu calls updatePointer() for the subclass. 
+		bool pointerRouted = false;
+		/// Menu the subclass is in. Its position is relative to it. 
+		Menu* parent = nullptr;
+		/// Order of subclass inside of its layer. 
+		int zIndex = 0;
+		/// Layer the subclass is drawn in. 
+		unsigned int layer = 0;
+		/// Index of the subclass in the components of its Menu. 
+		size_t drawIndex = 0;
+		/// Cached result of getWorldTransform(). 
+		mutable sf::Transform worldTransform;
+		/// Bumped every time worldTransform is recomputed. 
+		mutable unsigned int worldVersion = 0;
+		/// worldVersion of the parent when worldTransform was computed. 
+		mutable unsigned int parentWorldVersion = 0;
+
+		friend class Menu;
 
 		///////////////////////////////////////////////////////////
 		/// Method generateHitbox() is a private method that will 
@@ -134,4 +293,8 @@ namespace gs {
 		///////////////////////////////////////////////////////////  
 		virtual void generateHitbox() = 0;
 	};
+
+	inline Component::Dirty operator|(Component::Dirty a, Component::Dirty b) {
+		return static_cast<Component::Dirty>(static_cast<int>(a) | static_cast<int>(b));
+	}
 }
\ No newline at end of file
@@ -35,6 +35,7 @@
 #include "input/mouse.hpp"
 #include "input/key.hpp"
 #include "hitbox.hpp"
+#include "batch.hpp"
 #include "component.hpp"
 #include "style.hpp"
 #include "text.hpp"
@@ -45,5 +46,7 @@
 #include "textbox.hpp"
 #include "slider.hpp"
 #include "graph.hpp"
+#include "multiGraph.hpp"
+#include "timeSeries.hpp"
 #include "menu.hpp"
 #include "transition.hpp"
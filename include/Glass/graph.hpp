@@ -2,20 +2,28 @@
 
 // Dependencies 
 #include "sprite.hpp"
+#include "util/ringBuffer.hpp"
+#include "util/slidingExtrema.hpp"
+#include "util/concurrentQueue.hpp"
+#include "util/statistics.hpp"
 
 namespace gs {
+	class TimeSeriesFile;
+
 	namespace priv {
 		///////////////////////////////////////////////////////////
-		/// Function renderLine() will render a thin line between 
-		/// two points. 
-		/// @param sf::RenderTarget* target: Where to render to. 
-		/// @param Vec2f p1: First point. 
-		/// @param Vec2f p2: Second point. 
-		/// @param Color color: Line color. 
+		/// Function addMarkers() will add a small filled polygon 
+		/// around each vertex to a triangle list. 
+		/// @param const sf::Vertex* vertices: Centers of markers. 
+		/// @param size_t count: Number of vertices. 
+		/// @param float radius: Radius of markers. 
+		/// @param Color color: Marker color. 
+		/// @param sf::VertexArray& markers: Triangle list to add 
+		///  to. 
 		/////////////////////////////////////////////////////////// 
-		GLASS_EXPORT void renderLine(
-			sf::RenderTarget* target,
-			Vec2f p1, Vec2f p2, Color color
+		GLASS_EXPORT void addMarkers(
+			const sf::Vertex* vertices, size_t count,
+			float radius, Color color, sf::VertexArray& markers
 		);
 	}
 
@@ -25,6 +33,34 @@ namespace gs {
 	/////////////////////////////////////////////////////////// 
 	class GLASS_EXPORT Graph : public Component {
 	public:
+		///////////////////////////////////////////////////////////
+		/// enum class Decimation is how a Graph with more points 
+		/// than its width can show reduces them to about two 
+		/// points per pixel column before drawing. None draws 
+		/// every point. MinMax keeps the lowest and highest point 
+		/// of each column so spikes are never lost. 
+		/// LargestTriangle uses Largest-Triangle-Three-Buckets 
+		/// which keeps the points that best preserve the shape. 
+		///////////////////////////////////////////////////////////
+		enum class Decimation { None, MinMax, LargestTriangle };
+		///////////////////////////////////////////////////////////
+		/// enum class Producers is how many threads push samples 
+		/// to the ingest queue of a Graph. 
+		///////////////////////////////////////////////////////////
+		enum class Producers { Single, Multiple };
+		///////////////////////////////////////////////////////////
+		/// struct Sample is a value pushed from another thread. 
+		///////////////////////////////////////////////////////////
+		struct Sample {
+			/// Time the value was measured. Only used with 
+			/// Producers::Multiple, where the samples are sorted by 
+			/// time within each update(). A sample older than ones 
+			/// already graphed is still added after them. 
+			double time;
+			/// Height value of the point. 
+			float value;
+		};
+
 		Graph();
 		~Graph();
 
@@ -34,6 +70,11 @@ namespace gs {
 		///////////////////////////////////////////////////////////
 		virtual void update() override;
 		///////////////////////////////////////////////////////////
+		/// @returns bool: True since update() only reads the 
+		///  points of the Graph. 
+		///////////////////////////////////////////////////////////
+		virtual bool isUpdateThreadSafe() const override;
+		///////////////////////////////////////////////////////////
 		/// Method render() will render the Graph object to a 
 		/// sf::RenderTarget. Note: You can also render this object 
 		/// by calling gs::draw() aswell. 
@@ -47,6 +88,12 @@ namespace gs {
 			sf::RenderTarget* target,
 			sf::RenderStates renderStates = sf::RenderStates::Default
 		) override;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add the Graph to a 
+		/// RenderBatch. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch) override;
 
 		///////////////////////////////////////////////////////////
 		/// Method graph() will graph the next point on the Graph. 
@@ -54,10 +101,58 @@ namespace gs {
 		///////////////////////////////////////////////////////////
 		virtual void graph(float value);
 		///////////////////////////////////////////////////////////
+		/// Method graph() will graph many points at once. This is
+		/// much faster than graphing them one at a time. 
+		/// @param const float* values: Height values of the next
+		///  points, oldest first. 
+		/// @param size_t count: Number of values. 
+		///////////////////////////////////////////////////////////
+		virtual void graph(const float* values, size_t count);
+		///////////////////////////////////////////////////////////
 		/// Method clear() will erase all of the points from the 
-		/// point vector.  
+		/// Graph.  
 		///////////////////////////////////////////////////////////
 		virtual void clear();
+		///////////////////////////////////////////////////////////
+		/// Method graphRange() will replace the points with part 
+		/// of a recorded capture. Short ranges are shown sample by 
+		/// sample. Longer ones are read from the pyramid of the 
+		/// capture as the lowest and highest value of each pixel 
+		/// column, so zooming and panning only reads about two 
+		/// values per pixel. The pyramid is built in the 
+		/// background the first time so this never waits for it. 
+		/// Note: This changes the point count. Until 
+		/// source.hasPyramid() is true long ranges are estimated, 
+		/// so call this again once it is. 
+		/// @param TimeSeriesFile& source: Capture to read. 
+		/// @param int64_t beginTime: Time of first sample shown. 
+		/// @param int64_t endTime: Samples before this are shown. 
+		///////////////////////////////////////////////////////////
+		virtual void graphRange(TimeSeriesFile& source, int64_t beginTime, int64_t endTime);
+		///////////////////////////////////////////////////////////
+		/// Method setIngestQueue() will give the Graph a lock free 
+		/// queue other threads can push samples to. update() moves 
+		/// the queued samples onto the Graph. Note: Don't call it 
+		/// while other threads are pushing samples. 
+		/// @param size_t capacity: Most samples that can wait in 
+		///  the queue. 0 removes the queue. 
+		/// @param Producers producers: Single is wait-free but 
+		///  only one thread at a time may push. Multiple allows 
+		///  any thread to push. By default it is set to Single. 
+		///////////////////////////////////////////////////////////
+		virtual void setIngestQueue(size_t capacity, Producers producers = Producers::Single);
+		///////////////////////////////////////////////////////////
+		/// Method pushSample() will queue a point to be graphed on 
+		/// the next update(). Safe to call from other threads, see 
+		/// setIngestQueue(). 
+		/// @param float value: Height value of the point. 
+		/// @param double time: Time the value was measured. Only 
+		///  used to sort samples drained in the same update() 
+		///  with Producers::Multiple. 
+		/// @returns bool: False if the sample was dropped because 
+		///  the queue was full or there is no queue. 
+		///////////////////////////////////////////////////////////
+		bool pushSample(float value, double time = 0.0);
 
 		///////////////////////////////////////////////////////////
 		/// Method setPosition() will set the position of the top 
@@ -194,6 +289,54 @@ namespace gs {
 		/// @param Color color: New color. 
 		/////////////////////////////////////////////////////////// 
 		virtual void setPointColor(Color color);
+		///////////////////////////////////////////////////////////
+		/// Method setDecimation() will set how points are reduced 
+		/// when there are more than two per pixel column. By 
+		/// default it is set to Decimation::None. 
+		/// @param Decimation decimation: New decimation mode. 
+		/////////////////////////////////////////////////////////// 
+		virtual void setDecimation(Decimation decimation);
+		///////////////////////////////////////////////////////////
+		/// Method setScrolling() will set if the Graph keeps what 
+		/// it drew last frame and only draws the newest points. 
+		/// Older points are scrolled left with the texture. This 
+		/// makes graphing a stream cost the same no matter how 
+		/// many points are shown. Anything else that changes, 
+		/// such as a bound adjusting itself, redraws everything. 
+		/// By default it is set to false. 
+		/// @param bool enabled: True to enable, false to disable. 
+		/////////////////////////////////////////////////////////// 
+		virtual void setScrolling(bool enabled);
+		///////////////////////////////////////////////////////////
+		/// Method setStatistics() will set if the Graph keeps the 
+		/// mean, standard deviation and percentiles of its points 
+		/// and of every point ever graphed. They are updated as 
+		/// points are graphed so reading them doesn't sort the 
+		/// points. Enabling it starts from the points already on 
+		/// the Graph. By default it is set to false. 
+		/// @param bool enabled: True to enable, false to disable. 
+		/////////////////////////////////////////////////////////// 
+		virtual void setStatistics(bool enabled);
+		///////////////////////////////////////////////////////////
+		/// Method setStatisticBands() will set if horizontal lines 
+		/// are drawn at the mean and the 50th, 95th and 99th 
+		/// percentiles of the points. Statistics have to be 
+		/// enabled for them to show. By default it is set to 
+		/// false. 
+		/// @param bool enabled: True to enable, false to disable. 
+		/////////////////////////////////////////////////////////// 
+		virtual void setStatisticBands(bool enabled);
+		///////////////////////////////////////////////////////////
+		/// Method setBandColor() will change the color of the 
+		/// statistic bands. 
+		/// @param Color color: New color. 
+		/////////////////////////////////////////////////////////// 
+		virtual void setBandColor(Color color);
+		///////////////////////////////////////////////////////////
+		/// Method resetStatistics() will forget every point graphed
+		/// so far, including the all time statistics. 
+		/////////////////////////////////////////////////////////// 
+		virtual void resetStatistics();
 
 		///////////////////////////////////////////////////////////
 		/// @returns Vec2f: Position of Graph. 
@@ -268,9 +411,60 @@ namespace gs {
 		/// @returns Color: Color of points. 
 		/////////////////////////////////////////////////////////// 
 		virtual Color getPointColor() const;
+		///////////////////////////////////////////////////////////
+		/// @returns Decimation: How points are reduced. 
+		/////////////////////////////////////////////////////////// 
+		virtual Decimation getDecimation() const;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if only new points are drawn. 
+		/////////////////////////////////////////////////////////// 
+		virtual bool isScrolling() const;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if statistics are kept. 
+		/////////////////////////////////////////////////////////// 
+		virtual bool getStatistics() const;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if statistic bands are drawn. 
+		/////////////////////////////////////////////////////////// 
+		virtual bool getStatisticBands() const;
+		///////////////////////////////////////////////////////////
+		/// @returns Color: Color of statistic bands. 
+		/////////////////////////////////////////////////////////// 
+		virtual Color getBandColor() const;
+		///////////////////////////////////////////////////////////
+		/// Method getWindowStatistics() will return the statistics 
+		/// of the points on the Graph. Note: Percentiles are 
+		/// estimates and may cover up to an eighth of the point 
+		/// count more points. 
+		/// @returns util::Statistics: Statistics of the points. 
+		///  Empty if statistics aren't enabled. 
+		/////////////////////////////////////////////////////////// 
+		virtual util::Statistics getWindowStatistics() const;
+		///////////////////////////////////////////////////////////
+		/// Method getAllTimeStatistics() will return the 
+		/// statistics of every point graphed since statistics 
+		/// were enabled or reset. 
+		/// @returns util::Statistics: Statistics of all points. 
+		///  Empty if statistics aren't enabled. 
+		/////////////////////////////////////////////////////////// 
+		virtual util::Statistics getAllTimeStatistics() const;
+		///////////////////////////////////////////////////////////
+		/// @returns uint64_t: Number of samples dropped by 
+		///  pushSample(). Safe to call from other threads. 
+		/////////////////////////////////////////////////////////// 
+		uint64_t getDroppedSampleCount() const;
+		///////////////////////////////////////////////////////////
+		/// Method resetDroppedSampleCount() will set the number of 
+		/// dropped samples back to 0. 
+		/////////////////////////////////////////////////////////// 
+		void resetDroppedSampleCount();
 	protected:
-		/// Points that make up the Graph. 
-		vector<float> points;
+		/// Points that make up the Graph. Once full the oldest point is 
+		/// overwritten. 
+		util::RingBuffer<float> points;
+		/// Minimum and maximum of points. Kept up to date as points are 
+		/// graphed so auto adjusting the bounds doesn't scan them. 
+		util::SlidingExtrema<float> extrema;
 		/// Maximum number of points allowed on Graphs x axis.
 		size_t numOfPoints = 20;
 		/// Viewing bounds. 
@@ -289,16 +483,98 @@ namespace gs {
 		float outlineThickness;
 		/// Thickness of Graph points. 
 		float pointThickness;
+		/// How points are reduced when there are too many to see. 
+		Decimation decimation = Decimation::None;
+		/// Indices of the points left after decimation. 
+		vector<size_t> decimatedIndices;
+		/// Queue for samples from a single producer. 
+		std::unique_ptr<util::SpscQueue<Sample>> singleProducerQueue;
+		/// Queue for samples from many producers. 
+		std::unique_ptr<util::MpscQueue<Sample>> multiProducerQueue;
+		/// Samples pushSample() couldn't queue. 
+		std::atomic<uint64_t> droppedSamples{0};
+		/// Samples taken from the queue by update(). 
+		vector<Sample> drainedSamples;
+		/// Values of drainedSamples. 
+		vector<float> drainedValues;
+		/// Statistics of the points. Null unless enabled. 
+		std::unique_ptr<util::StreamStatistics> statistics;
+		/// Draw lines at the mean and percentiles? 
+		bool statisticBands = false;
+		/// Color of statistic bands. 
+		Color bandColor;
+		/// Values read by graphRange(). 
+		vector<float> rangeValues;
 		/// Texture used to render Graph onto. 
 		sf::RenderTexture graphTexture;
+		/// Second texture used when scrolling. The Graph is scrolled from 
+		/// one texture into the other. 
+		sf::RenderTexture scrollBuffer;
+		/// Texture holding the current Graph. Either graphTexture or 
+		/// scrollBuffer. 
+		sf::RenderTexture* frontTexture;
 		/// Sprite used to move Graph. 
 		Sprite graphSprite;
+		/// Line strip through all of the points. 
+		sf::VertexArray lineVertices;
+		/// Triangles of all of the point markers. 
+		sf::VertexArray pointVertices;
+		/// Lines of the statistic bands. 
+		sf::VertexArray bandVertices;
+		/// True if the points, bounds, size or colors changed since the 
+		/// vertices were generated. 
+		bool verticesStale = true;
+		/// Draw only the newest points? 
+		bool scrolling = false;
+		/// True if something other than new points changed since the 
+		/// texture was drawn. 
+		bool redrawAll = true;
+		/// Points graphed since the texture was drawn. 
+		size_t appendedPoints = 0;
+		/// Number of points when the texture was drawn. 
+		size_t drawnPointCount = 0;
+		/// Fraction of a pixel the points are drawn right of where they 
+		/// should be after scrolling. 
+		float scrollOffset = 0.0f;
+		/// Bumped by every change to what the texture shows. 
+		uint64_t generation = 1;
+		/// Generation the texture was last drawn at. 
+		uint64_t drawnGeneration = 0;
 
 		///////////////////////////////////////////////////////////
 		/// Method generateHitbox() is a private method that will 
 		/// update the internal Hitbox to match the current object. 
 		/////////////////////////////////////////////////////////// 
 		virtual void generateHitbox() override;
+		///////////////////////////////////////////////////////////
+		/// Method updateTexture() is a private method that will 
+		/// redraw the points of the Graph onto graphTexture. 
+		/////////////////////////////////////////////////////////// 
+		virtual void updateTexture();
+		///////////////////////////////////////////////////////////
+		/// Method generateVertices() is a private method that will 
+		/// rebuild lineVertices, pointVertices and bandVertices 
+		/// from the points. 
+		/////////////////////////////////////////////////////////// 
+		virtual void generateVertices();
+		///////////////////////////////////////////////////////////
+		/// Method scrollTexture() is a private method that will 
+		/// scroll the last frame left and draw only the newest 
+		/// points. 
+		/// @returns bool: False if everything has to be redrawn. 
+		/////////////////////////////////////////////////////////// 
+		virtual bool scrollTexture();
+		///////////////////////////////////////////////////////////
+		/// Method drainIngestQueue() is a private method that will 
+		/// graph every sample waiting in the ingest queue. 
+		/////////////////////////////////////////////////////////// 
+		virtual void drainIngestQueue();
+		///////////////////////////////////////////////////////////
+		/// Method invalidate() is a private method that will make 
+		/// the next render redraw the whole texture. 
+		/// @param Dirty flags: Parts that changed. 
+		/////////////////////////////////////////////////////////// 
+		void invalidate(Dirty flags);
 	};
 
 	///////////////////////////////////////////////////////////
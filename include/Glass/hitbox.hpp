@@ -119,6 +119,11 @@ namespace gs {
 		/// @returns Vec2f: Center position of shape. 
 		///////////////////////////////////////////////////////////
 		Vec2f getCenter() const;
+		///////////////////////////////////////////////////////////
+		/// @returns sf::FloatRect: Axis aligned box containing the 
+		///  whole Hitbox regardless of its shape. 
+		///////////////////////////////////////////////////////////
+		sf::FloatRect getBounds() const;
 
 	private:
 		/// Position of the Hitbox as a 2d coordinate. 
@@ -24,6 +24,11 @@ namespace gs {
 
 		/// Unicode value of last inputed character from keyboard. 
 		GLASS_EXPORT extern unsigned int textUnicode;
+		/// Last key pressed this frame, repeating while held. 
+		/// sf::Keyboard::Unknown if none. 
+		GLASS_EXPORT extern sf::Keyboard::Key keyPressed;
+		/// True if shift was held when keyPressed was pressed. 
+		GLASS_EXPORT extern bool keyShift;
 
 		///////////////////////////////////////////////////////////         
 		/// Function setWindow() will give a window to Glass for 
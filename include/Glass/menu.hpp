@@ -2,6 +2,12 @@
 
 // Dependencies 
 #include "component.hpp"
+#include "threadPool.hpp"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace gs {
 
@@ -12,10 +18,47 @@ namespace gs {
 
 	///////////////////////////////////////////////////////////
 	/// class Menu is a multipurpose Component class that can
-	/// be used to store and manipulate other Components. 
+	/// be used to store and manipulate other Components. The 
+	/// positions of the Components are relative to the Menu 
+	/// so Menus can be nested to build a hierarchy. 
 	///////////////////////////////////////////////////////////  
 	class GLASS_EXPORT Menu : public Component {
 	public:
+		/// How the Menu should render its Components. Immediate calls render()
+		/// on every Component. Batched merges their geometry into as few draw 
+		/// calls as possible. By default it is set to Immediate. 
+		enum class RenderMethod { Immediate, Batched }
+			renderMethod = RenderMethod::Immediate;
+		/// How the Menu should update its Components. Serial updates them one 
+		/// after another. Parallel spreads Components that are thread safe 
+		/// over the threads of priv::ThreadPool::getDefault() while the rest 
+		/// are updated in order between them. By default it is set to Serial.
+		enum class UpdateMethod { Serial, Parallel }
+			updateMethod = UpdateMethod::Serial;
+		/// Skip Components outside of the view of the target when rendering.
+		/// Nested Menus are skipped as a whole. By default it is set to true. 
+		bool culling = true;
+
+		///////////////////////////////////////////////////////////
+		/// struct Handle refers to a Component added to the Menu. 
+		/// Unlike a Component* it can be stored safely: once the 
+		/// Component is removed the Handle stops resolving even if
+		/// its slot is reused by a new Component. 
+		///////////////////////////////////////////////////////////
+		struct Handle {
+			/// Slot of the Component inside the Menu. 
+			uint32_t index = 0;
+			/// Generation of the slot when the Handle was made. 0 is never valid. 
+			uint32_t generation = 0;
+
+			bool operator==(const Handle& other) const {
+				return index == other.index && generation == other.generation;
+			}
+			bool operator!=(const Handle& other) const {
+				return !(*this == other);
+			}
+		};
+
 		Menu();
 		~Menu();
 
@@ -39,34 +82,102 @@ namespace gs {
 			sf::RenderTarget* target,
 			sf::RenderStates renderStates = sf::RenderStates::Default
 		) override;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add all of the Components in the 
+		/// Menu to a RenderBatch. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch) override;
 
 		///////////////////////////////////////////////////////////
 		/// Method add() will add a Component to the components 
 		/// vector.
 		/// @param Component* component: Pointer to component. 
 		/// @param const std::string& name: Name of component. 
+		/// @returns Handle: Stable handle to the Component. 
 		///////////////////////////////////////////////////////////
-		virtual void add(Component* component, const std::string& name);
+		virtual Handle add(Component* component, const std::string& name);
 		///////////////////////////////////////////////////////////
 		/// Method add() will add a Component to the components 
 		/// vector.
 		/// @param Component* component: Pointer to component. 
+		/// @returns Handle: Stable handle to the Component. 
 		///////////////////////////////////////////////////////////
-		virtual void add(Component* component);
+		virtual Handle add(Component* component);
 		///////////////////////////////////////////////////////////
 		/// Method remove() will remove a Component from the vector 
-		/// if it finds a Component of the same address. 
+		/// if it finds a Component of the same address. It is 
+		/// found from its drawIndex without searching. 
 		/// @param Component* component: Address of Component to
 		///  remove. 
 		///////////////////////////////////////////////////////////
 		virtual void remove(Component* component); 
 		///////////////////////////////////////////////////////////
-		/// Method remove() will remove a Component from the vector 
-		/// if it finds a Component of the same name. 
-		/// @param Component* component: Address of Component to
+		/// Method remove() will remove the first Component added 
+		/// with a name. It is found through the name index 
+		/// without searching. 
+		/// @param const std::string& name: Name of Component to
 		///  remove. 
 		///////////////////////////////////////////////////////////
 		virtual void remove(const std::string& name);  
+		///////////////////////////////////////////////////////////
+		/// Method remove() will remove the Component a Handle 
+		/// refers to. Nothing happens if the Handle is stale. 
+		/// @param Handle handle: Handle returned by add(). 
+		///////////////////////////////////////////////////////////
+		virtual void remove(Handle handle);  
+
+		///////////////////////////////////////////////////////////
+		/// Method setCached() will make the Menu render its 
+		/// Components once into an offscreen texture and draw 
+		/// that texture as a single quad on later frames. The 
+		/// texture is only redrawn when one of the Components 
+		/// reports a change with hasChanged(). Note: This is best
+		/// used for Menus that rarely change like static panels. 
+		/// @param bool cached: True to enable the cache. 
+		///////////////////////////////////////////////////////////
+		void setCached(bool cached);
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if the Menu renders from its cache.
+		///////////////////////////////////////////////////////////
+		bool isCached() const;
+		///////////////////////////////////////////////////////////
+		/// Method invalidateCache() will force the cache to be 
+		/// redrawn on the next render(). Use it when something 
+		/// the Menu can't track changed. Example: A font or 
+		/// texture used by a Component was reloaded. 
+		///////////////////////////////////////////////////////////
+		void invalidateCache();
+		///////////////////////////////////////////////////////////
+		/// Method setPartialRedraw() will make the Menu keep a 
+		/// persistent backbuffer the size of the target and only
+		/// redraw the areas of it covered by Components that 
+		/// changed since the last frame. The backbuffer is then 
+		/// drawn to the target as a single quad. Note: The Menu 
+		/// is drawn using the default view of the target. 
+		/// @param bool enabled: True to enable partial redraws. 
+		///////////////////////////////////////////////////////////
+		void setPartialRedraw(bool enabled);
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if the Menu uses partial redraws. 
+		///////////////////////////////////////////////////////////
+		bool isPartialRedraw() const;
+		///////////////////////////////////////////////////////////
+		/// Method addDamage() will mark an area to be redrawn on
+		/// the next render(). Use it when something the Menu 
+		/// can't track changed. 
+		/// @param sf::FloatRect area: Area in pixels. 
+		///////////////////////////////////////////////////////////
+		void addDamage(sf::FloatRect area);
+		///////////////////////////////////////////////////////////
+		/// Method getDamage() will return the areas redrawn by the
+		/// last render() call when partial redraws are enabled. 
+		/// They are snapped to whole pixels and don't overlap 
+		/// more than needed so they can be used to only send the
+		/// changed parts of a frame somewhere else. 
+		/// @returns const vector<sf::FloatRect>&: Changed areas. 
+		///////////////////////////////////////////////////////////
+		const vector<sf::FloatRect>& getDamage() const;
 
 		///////////////////////////////////////////////////////////
 		/// Method setPosition() will set the offset of all of the
@@ -146,6 +257,32 @@ namespace gs {
 		/// @returns bool: True if Menu is locked. 
 		///////////////////////////////////////////////////////////
 		virtual bool isLocked() const override;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of draw calls made by the last 
+		///  render() call. Note: Only counted when renderMethod is
+		///  set to Batched. Components that couldn't be batched 
+		///  are counted by getFallbackCount() instead. 
+		///////////////////////////////////////////////////////////
+		virtual size_t getDrawCallCount() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of Components the last render() 
+		///  call had to render one by one because they couldn't be
+		///  batched. 
+		///////////////////////////////////////////////////////////
+		virtual size_t getFallbackCount() const;
+		///////////////////////////////////////////////////////////
+		/// Method hasChanged() will check if the Menu or any of 
+		/// its Components changed since the Menu was last 
+		/// rendered. If it returns false then the last frame can 
+		/// be presented again as is. 
+		/// @returns bool: True if the Menu needs to be redrawn. 
+		///////////////////////////////////////////////////////////
+		virtual bool hasChanged() const override;
+		///////////////////////////////////////////////////////////
+		/// @returns sf::Transform: Offset applied to the 
+		///  Components by the position of the Menu. 
+		///////////////////////////////////////////////////////////
+		virtual sf::Transform getLocalTransform() const override;
 
 		///////////////////////////////////////////////////////////
 		/// Method operator[]() will return a pointer to the 
@@ -163,6 +300,35 @@ namespace gs {
 		///  nullptr instead. 
 		///////////////////////////////////////////////////////////
 		Component* operator[](const std::string& name);
+		///////////////////////////////////////////////////////////
+		/// Method find() will return a pointer to the first 
+		/// Component added with a given name using a hashed 
+		/// lookup. 
+		/// @param std::string_view name: Name of Component. 
+		/// @returns Component*: Pointer to Component or nullptr if
+		///  no Component has that name. 
+		///////////////////////////////////////////////////////////
+		Component* find(std::string_view name) const;
+		///////////////////////////////////////////////////////////
+		/// Method get() will return the Component a Handle refers
+		/// to. 
+		/// @param Handle handle: Handle returned by add(). 
+		/// @returns Component*: Pointer to Component or nullptr if
+		///  it has been removed. 
+		///////////////////////////////////////////////////////////
+		Component* get(Handle handle) const;
+		///////////////////////////////////////////////////////////
+		/// @param std::string_view name: Name of Component. 
+		/// @returns Handle: Handle of the first Component with 
+		///  that name. The Handle is invalid if none is found. 
+		///////////////////////////////////////////////////////////
+		Handle getHandle(std::string_view name) const;
+		///////////////////////////////////////////////////////////
+		/// @param Handle handle: Handle to check. 
+		/// @returns bool: True if the Handle still refers to a 
+		///  Component in the Menu. 
+		///////////////////////////////////////////////////////////
+		bool isValid(Handle handle) const;
 		
 		///////////////////////////////////////////////////////////
 		/// struct ComponentContainer is a private struct used to 
@@ -174,10 +340,93 @@ namespace gs {
 			Component* ptr = nullptr;
 			/// Optional name of Component. 
 			std::string name;
+			/// Handle of Component. 
+			Handle handle;
+			/// Order the Component was added in. Breaks ties between 
+			/// Components with the same layer and z-index. 
+			uint64_t sequence = 0;
+			/// Area of the backbuffer covered by the Component when it was last
+			/// drawn with partial redraws. 
+			sf::FloatRect drawnBounds;
 		}; 
-		/// Vector of the Components in the Menu. 
+		/// Vector of the Components in the Menu sorted in draw order by layer
+		/// and z-index. 
 		vector<ComponentContainer> components;
 	protected:
+		/// Geometry of the Components when using RenderMethod::Batched. 
+		RenderBatch renderBatch;
+		/// Index of Component Hitboxes used to find what is under the mouse. 
+		priv::SpatialGrid hitGrid;
+		/// Components that were under the mouse last update. 
+		vector<Component*> hoveredComponents;
+		/// Scratch vectors used by updatePointers(). 
+		vector<Component*> pointerCandidates, pointerHits;
+
+		///////////////////////////////////////////////////////////
+		/// struct Slot is a private struct that a Handle points to. 
+		///////////////////////////////////////////////////////////
+		struct Slot {
+			/// Component stored in the slot or nullptr if free. 
+			Component* ptr = nullptr;
+			/// Bumped every time the slot is freed. 
+			uint32_t generation = 1;
+			/// Slots of Components sharing the name of this one, in the 
+			/// order they were added. The list wraps around. 
+			uint32_t previousNamed = 0, nextNamed = 0;
+		};
+		/// Slots referred to by Handles. 
+		vector<Slot> slots;
+		/// Indices of free slots. 
+		vector<uint32_t> freeSlots;
+		/// Offscreen texture the Components are rendered into when cached. 
+		std::unique_ptr<sf::RenderTexture> cacheTexture;
+		/// Quad showing the used part of cacheTexture. 
+		sf::Sprite cacheSprite;
+		/// True when cacheTexture holds the current Components. 
+		bool cacheValid = false;
+		/// Persistent copy of the frame used by partial redraws. 
+		std::unique_ptr<sf::RenderTexture> backbuffer;
+		/// Quad showing backbuffer. 
+		sf::Sprite backbufferSprite;
+		/// Areas to redraw on the next render() that can't be found from 
+		/// the Components. Example: Where a removed Component was. 
+		vector<sf::FloatRect> pendingDamage;
+		/// Areas redrawn by the last render(). 
+		vector<sf::FloatRect> damage;
+		/// Transform the backbuffer was last drawn with. 
+		sf::Transform drawnTransform;
+		/// Area covered by the Components. Recomputed when the Hitbox flag
+		/// is set. 
+		mutable sf::FloatRect contentBounds;
+		/// Storage for names so nameIndex can key on std::string_view. 
+		std::unordered_set<std::string> internedNames;
+		/// Slot of the first Component added with each name. 
+		std::unordered_map<std::string_view, uint32_t> nameIndex;
+		/// Components whose layer or z-index changed since components 
+		/// was last sorted. 
+		vector<Component*> reordered;
+		/// True if too many changed to move one at a time. 
+		bool reorderAll = false;
+		/// Sequence given to the next Component added. 
+		uint64_t nextSequence = 0;
+
+		///////////////////////////////////////////////////////////
+		/// struct SortKey is a private struct used by radixSort().
+		///////////////////////////////////////////////////////////
+		struct SortKey {
+			/// Layer and z-index packed by getOrderKey(). 
+			uint64_t order;
+			/// Sequence of Component. 
+			uint64_t sequence;
+			/// Index of Component in components before sorting. 
+			size_t index;
+		};
+		/// Scratch vectors used by radixSort(). 
+		vector<SortKey> sortKeys, sortScratch;
+		/// Scratch vector used by radixSort(). 
+		vector<ComponentContainer> sortedComponents;
+
+		friend class Component;
 
 		///////////////////////////////////////////////////////////
 		/// Method generateHitbox() is a private method that will 
@@ -186,11 +435,150 @@ namespace gs {
 		virtual void generateHitbox() override;
 
 		///////////////////////////////////////////////////////////
-		/// Method updateInternalComponents() will update the 
-		/// position of the Components offset to match the Menu
-		/// position. 
+		/// Method renderComponents() will draw the Components 
+		/// with the current renderMethod ignoring the cache. 
+		/// @param sf::RenderTarget* target: Target to draw to. 
+		/// @param sf::RenderStates renderStates: States to use. 
+		///////////////////////////////////////////////////////////  
+		void renderComponents(sf::RenderTarget* target, sf::RenderStates renderStates);
+		///////////////////////////////////////////////////////////
+		/// Method batchComponents() will add the Components to a 
+		/// RenderBatch ignoring the cache. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////  
+		void batchComponents(RenderBatch& batch);
+		///////////////////////////////////////////////////////////
+		/// Method updateCache() will redraw cacheTexture if it is
+		/// stale. 
+		/// @returns bool: False if the cache can't be used and 
+		///  the Components should be drawn directly. 
+		///////////////////////////////////////////////////////////  
+		bool updateCache();
+		///////////////////////////////////////////////////////////
+		/// Method renderDamage() will redraw the damaged areas of
+		/// backbuffer and draw it to the target. 
+		/// @param sf::RenderTarget* target: Target to draw to. 
+		/// @param sf::RenderStates renderStates: States to use. 
+		/// @returns bool: False if the backbuffer can't be used 
+		///  and the Components should be drawn directly. 
+		///////////////////////////////////////////////////////////  
+		bool renderDamage(sf::RenderTarget* target, sf::RenderStates renderStates);
+		///////////////////////////////////////////////////////////
+		/// Method collectDamage() will fill damage with the old 
+		/// and new areas of every Component that changed merged
+		/// into as few rectangles as possible. 
+		/// @param Vec2f area: Size of backbuffer. Damage outside 
+		///  of it is dropped. 
+		/// @param const sf::Transform& transform: Transform from 
+		///  the Menu to the backbuffer. 
+		///////////////////////////////////////////////////////////  
+		void collectDamage(Vec2f area, const sf::Transform& transform);
+		///////////////////////////////////////////////////////////
+		/// Method getContentBounds() will return the area covered
+		/// by all of the Components in the Menu. It is cached and
+		/// only recomputed after a Component moved or changed 
+		/// size. 
+		/// @returns const sf::FloatRect&: Area of Components. 
+		///  Empty if the Menu has none. 
+		///////////////////////////////////////////////////////////  
+		const sf::FloatRect& getContentBounds() const;
+		///////////////////////////////////////////////////////////
+		/// Method getDrawBounds() will return the area a Component
+		/// draws to including some padding for outlines and 
+		/// shadows. 
+		/// @param const Component* component: Component to check.
+		/// @returns sf::FloatRect: Area drawn to. 
+		///////////////////////////////////////////////////////////  
+		static sf::FloatRect getDrawBounds(const Component* component);
+		///////////////////////////////////////////////////////////
+		/// Method getVisibleArea() will return the area of the 
+		/// view of a target in the space the Components are drawn
+		/// in. 
+		/// @param const sf::RenderTarget* target: Target to check.
+		/// @param const sf::RenderStates& renderStates: States 
+		///  the Components are drawn with. 
+		/// @returns sf::FloatRect: Bounding box of visible area. 
+		///////////////////////////////////////////////////////////  
+		static sf::FloatRect getVisibleArea(
+			const sf::RenderTarget* target, const sf::RenderStates& renderStates
+		);
+		///////////////////////////////////////////////////////////
+		/// Method updatePointers() will look up the Components 
+		/// under the mouse in hitGrid and call updatePointer() on
+		/// them and on the ones the mouse just left. 
+		///////////////////////////////////////////////////////////  
+		virtual void updatePointers();
+		///////////////////////////////////////////////////////////
+		/// Method updateParallel() will update the Components in
+		/// [begin, end) on the thread pool. They must all be 
+		/// thread safe. 
+		/// @param size_t begin: Index of first Component. 
+		/// @param size_t end: One past index of last Component. 
+		///////////////////////////////////////////////////////////  
+		void updateParallel(size_t begin, size_t end);
+		///////////////////////////////////////////////////////////
+		/// Method reorder() is called by a Component when its 
+		/// layer or z-index changed. 
+		/// @param Component* component: Component that changed. 
+		///////////////////////////////////////////////////////////  
+		void reorder(Component* component);
+		///////////////////////////////////////////////////////////
+		/// Method sortComponents() will sort components if any of
+		/// them changed layer or z-index. A few changes are 
+		/// moved into place one at a time since the rest is still 
+		/// sorted. Bulk changes are sorted with radix sort. 
+		///////////////////////////////////////////////////////////  
+		void sortComponents();
+		///////////////////////////////////////////////////////////
+		/// Method insertionSort() will move each reordered 
+		/// Component to where a binary search over the others 
+		/// finds it belongs. Only Components from the first moved 
+		/// position on get a new drawIndex. 
+		///////////////////////////////////////////////////////////  
+		void insertionSort();
+		///////////////////////////////////////////////////////////
+		/// Method radixSort() will sort components by sorting 
+		/// their keys a byte at a time. 
+		///////////////////////////////////////////////////////////  
+		void radixSort();
+		///////////////////////////////////////////////////////////
+		/// @param const ComponentContainer& a: First Component. 
+		/// @param const ComponentContainer& b: Second Component. 
+		/// @returns bool: True if a is drawn before b. 
+		///////////////////////////////////////////////////////////  
+		static bool isDrawnBefore(const ComponentContainer& a, const ComponentContainer& b);
+		///////////////////////////////////////////////////////////
+		/// @param const Component* component: Component to check.
+		/// @returns uint64_t: Layer and z-index of Component 
+		///  packed so that comparing keys compares draw order. 
+		///////////////////////////////////////////////////////////  
+		static uint64_t getOrderKey(const Component* component);
+		///////////////////////////////////////////////////////////
+		/// Method attach() will register a Component added to the
+		/// Menu with hitGrid. 
+		/// @param Component* component: Added Component. 
+		///////////////////////////////////////////////////////////  
+		void attach(Component* component);
+		///////////////////////////////////////////////////////////
+		/// Method detach() will unregister a Component removed 
+		/// from the Menu. 
+		/// @param Component* component: Removed Component. 
+		///////////////////////////////////////////////////////////  
+		void detach(Component* component);
+		///////////////////////////////////////////////////////////
+		/// Method release() will free the slot and name of a 
+		/// Component that has been taken out of components. 
+		/// @param const ComponentContainer& container: Removed 
+		///  Component. 
+		///////////////////////////////////////////////////////////  
+		void release(const ComponentContainer& container);
+		///////////////////////////////////////////////////////////
+		/// Method removeAt() will remove one Component keeping the 
+		/// order of the rest. Only the Components after it are 
+		/// moved. 
+		/// @param size_t index: Index in components. 
 		///////////////////////////////////////////////////////////  
-		virtual void updateInternalComponents();
+		void removeAt(size_t index);
 	};
 
 	///////////////////////////////////////////////////////////
@@ -0,0 +1,382 @@
+#pragma once
+
+// Dependencies
+#include "graph.hpp"
+
+namespace gs {
+	///////////////////////////////////////////////////////////
+	/// class MultiGraph is a class used for displaying many
+	/// series of height data on the same axes. Every series
+	/// has its own color and points but they share the bounds,
+	/// one texture and one vertex array, so the cost grows
+	/// with the number of charts instead of series.
+	///////////////////////////////////////////////////////////
+	class GLASS_EXPORT MultiGraph : public Component {
+	public:
+		MultiGraph();
+		~MultiGraph();
+
+		///////////////////////////////////////////////////////////
+		/// Method update() is an overriden Component method that
+		/// is used to update the MultiGraph every time a frame
+		/// passes.
+		///////////////////////////////////////////////////////////
+		virtual void update() override;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True since update() only reads the
+		///  points of the MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual bool isUpdateThreadSafe() const override;
+		///////////////////////////////////////////////////////////
+		/// Method render() will render the MultiGraph object to a
+		/// sf::RenderTarget. Note: You can also render this object
+		/// by calling gs::draw() aswell.
+		/// @param sf::RenderTarget* target: Pointer to the target
+		///  you want to render. Example: &window.
+		/// @param sf::RenderStates: Used for advanced blending and
+		///  custom shaders. By default it is set to
+		///  sf::RenderStates::Default.
+		///////////////////////////////////////////////////////////
+		virtual void render(
+			sf::RenderTarget* target,
+			sf::RenderStates renderStates = sf::RenderStates::Default
+		) override;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add the MultiGraph to a
+		/// RenderBatch.
+		/// @param RenderBatch& batch: Batch to add geometry to.
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch) override;
+
+		///////////////////////////////////////////////////////////
+		/// Method addSeries() will add an empty series.
+		/// @param Color color: Color of the series line.
+		/// @returns size_t: Index of the new series.
+		///////////////////////////////////////////////////////////
+		virtual size_t addSeries(Color color);
+		///////////////////////////////////////////////////////////
+		/// Method removeSeries() will remove a series. Series
+		/// after it move down one index.
+		/// @param size_t series: Index of series.
+		///////////////////////////////////////////////////////////
+		virtual void removeSeries(size_t series);
+		///////////////////////////////////////////////////////////
+		/// Method graph() will graph the next point of a series.
+		/// @param size_t series: Index of series.
+		/// @param float value: Height value of next point.
+		///////////////////////////////////////////////////////////
+		virtual void graph(size_t series, float value);
+		///////////////////////////////////////////////////////////
+		/// Method graph() will graph many points of a series at
+		/// once.
+		/// @param size_t series: Index of series.
+		/// @param const float* values: Height values of the next
+		///  points, oldest first.
+		/// @param size_t count: Number of values.
+		///////////////////////////////////////////////////////////
+		virtual void graph(size_t series, const float* values, size_t count);
+		///////////////////////////////////////////////////////////
+		/// Method clear() will erase all of the points from every
+		/// series. The series themselves are kept.
+		///////////////////////////////////////////////////////////
+		virtual void clear();
+
+		///////////////////////////////////////////////////////////
+		/// Method setPosition() will set the position of the top
+		/// left corner of the MultiGraph object.
+		/// @param Vec2f position: New position of MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual void setPosition(Vec2f position) override;
+		///////////////////////////////////////////////////////////
+		/// Method setPosition() will set the position of the top
+		/// left corner of the MultiGraph object.
+		/// @param float xpos: New xpos of MultiGraph.
+		/// @param float ypos: New ypos of MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual void setPosition(float xpos, float ypos) override;
+		///////////////////////////////////////////////////////////
+		/// Method setCenter() will set the position of the
+		/// MultiGraph to be centered at the position given.
+		/// @param Vec2f position: Center of MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual void setCenter(Vec2f position) override;
+		///////////////////////////////////////////////////////////
+		/// Method setCenter() will set the position of the
+		/// MultiGraph to be centered at the position given.
+		/// @param float xpos: Xpos of center.
+		/// @param float ypos: Ypos of center.
+		///////////////////////////////////////////////////////////
+		virtual void setCenter(float xpos, float ypos) override;
+		///////////////////////////////////////////////////////////
+		/// Method move() will add an offset to the position of the
+		/// MultiGraph object.
+		/// @param Vec2f offset: Positional offset of MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual void move(Vec2f offset) override;
+		///////////////////////////////////////////////////////////
+		/// Method move() will add an offset to the position of the
+		/// MultiGraph object.
+		/// @param float offsetx: X distance to offset.
+		/// @param float offsety: Y distance to offset.
+		///////////////////////////////////////////////////////////
+		virtual void move(float offsetx, float offsety) override;
+		///////////////////////////////////////////////////////////
+		/// Method applyStyle() will change the visual
+		/// representation of the MultiGraph by changing it's
+		/// style.
+		/// @param const Style& style: Style to apply.
+		///////////////////////////////////////////////////////////
+		virtual void applyStyle(const Style& style) override;
+		///////////////////////////////////////////////////////////
+		/// Method lock() will disable updates to the MultiGraph
+		/// object.
+		///////////////////////////////////////////////////////////
+		virtual void lock() override;
+		///////////////////////////////////////////////////////////
+		/// Method unlock() will enable updates to the MultiGraph
+		/// object.
+		///////////////////////////////////////////////////////////
+		virtual void unlock() override;
+
+		///////////////////////////////////////////////////////////
+		/// Method setSize() will set the size of the MultiGraph.
+		/// @param Vec2f size: New size.
+		///////////////////////////////////////////////////////////
+		virtual void setSize(Vec2f size);
+		///////////////////////////////////////////////////////////
+		/// Method setSize() will set the size of the MultiGraph.
+		/// @param float width: New width.
+		/// @param float height New height.
+		///////////////////////////////////////////////////////////
+		virtual void setSize(float width, float height);
+		///////////////////////////////////////////////////////////
+		/// Method setLowerBound() will set the minimum yvalue that
+		/// can be viewed on the MultiGraph. Note: To automatically
+		/// adjust it call setLowerBoundAutoAdjust().
+		/// @param float height: Height value.
+		///////////////////////////////////////////////////////////
+		virtual void setLowerBound(float height);
+		///////////////////////////////////////////////////////////
+		/// Method setUpperBound() will set the maximum yvalue that
+		/// can be viewed on the MultiGraph. Note: To automatically
+		/// adjust it call setUpperBoundAutoAdjust().
+		/// @param float height: Height value.
+		///////////////////////////////////////////////////////////
+		virtual void setUpperBound(float height);
+		///////////////////////////////////////////////////////////
+		/// Method setLowerBoundAutoAdjust() will set if the lower
+		/// bound should follow the lowest point of all series.
+		/// @param bool enabled: True to enable, false to disable.
+		///////////////////////////////////////////////////////////
+		virtual void setLowerBoundAutoAdjust(bool enabled);
+		///////////////////////////////////////////////////////////
+		/// Method setUpperBoundAutoAdjust() will set if the upper
+		/// bound should follow the highest point of all series.
+		/// @param bool enabled: True to enable, false to disable.
+		///////////////////////////////////////////////////////////
+		virtual void setUpperBoundAutoAdjust(bool enabled);
+		///////////////////////////////////////////////////////////
+		/// Method setPointCount() will set the number of points at
+		/// one time that can be in a series before it scrolls.
+		/// @param size_t numOfPoints: Point count.
+		///////////////////////////////////////////////////////////
+		virtual void setPointCount(size_t numOfPoints);
+		///////////////////////////////////////////////////////////
+		/// Method setSeriesColor() will set the color of a series.
+		/// @param size_t series: Index of series.
+		/// @param Color color: New color.
+		///////////////////////////////////////////////////////////
+		virtual void setSeriesColor(size_t series, Color color);
+		///////////////////////////////////////////////////////////
+		/// Method setFillColor() will set the background color of
+		/// the MultiGraph.
+		/// @param Color color: New color.
+		///////////////////////////////////////////////////////////
+		virtual void setFillColor(Color color);
+		///////////////////////////////////////////////////////////
+		/// Method setOutlineThickness() will set the thickness of
+		/// the outline surrounding the MultiGraph.
+		/// @param float thickness: Thickness in pixels.
+		///////////////////////////////////////////////////////////
+		virtual void setOutlineThickness(float thickness);
+		///////////////////////////////////////////////////////////
+		/// Method setOutlineColor() will change the color of the
+		/// MultiGraphs boarder outline.
+		/// @param Color color: New color.
+		///////////////////////////////////////////////////////////
+		virtual void setOutlineColor(Color color);
+		///////////////////////////////////////////////////////////
+		/// Method setPointThickness() will set the radius of the
+		/// points of every series. The points use the color of
+		/// their series. Note: By default it is set to 0.0 which
+		/// disables them.
+		/// @param float thickness: New radius of points in pixels.
+		///////////////////////////////////////////////////////////
+		virtual void setPointThickness(float thickness);
+
+		///////////////////////////////////////////////////////////
+		/// @returns Vec2f: Position of MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual Vec2f getPosition() const override;
+		///////////////////////////////////////////////////////////
+		/// @returns Vec2f: Center position of MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual Vec2f getCenter() const override;
+		///////////////////////////////////////////////////////////
+		/// @returns const Hitbox&: Reference to internal Hitbox.
+		///////////////////////////////////////////////////////////
+		virtual const Hitbox& getHitbox() const override;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if locked.
+		///////////////////////////////////////////////////////////
+		virtual bool isLocked() const override;
+
+		///////////////////////////////////////////////////////////
+		/// @returns Vec2f: Size of MultiGraph.
+		///////////////////////////////////////////////////////////
+		virtual Vec2f getSize() const;
+		///////////////////////////////////////////////////////////
+		/// @returns float: Minimum value on graph.
+		///////////////////////////////////////////////////////////
+		virtual float getLowerBound() const;
+		///////////////////////////////////////////////////////////
+		/// @returns float: Maximum value on graph.
+		///////////////////////////////////////////////////////////
+		virtual float getUpperBound() const;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if lower bound automatically
+		///  adjusts.
+		///////////////////////////////////////////////////////////
+		virtual bool getLowerBoundAutoAdjust() const;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if upper bound automatically
+		///  adjusts.
+		///////////////////////////////////////////////////////////
+		virtual bool getUpperBoundAutoAdjust() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of viewable points per series.
+		///////////////////////////////////////////////////////////
+		virtual size_t getPointCount() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of series.
+		///////////////////////////////////////////////////////////
+		virtual size_t getSeriesCount() const;
+		///////////////////////////////////////////////////////////
+		/// @param size_t series: Index of series.
+		/// @returns Color: Color of series.
+		///////////////////////////////////////////////////////////
+		virtual Color getSeriesColor(size_t series) const;
+		///////////////////////////////////////////////////////////
+		/// @returns Color: Fill color of MultiGraph background.
+		///////////////////////////////////////////////////////////
+		virtual Color getFillColor() const;
+		///////////////////////////////////////////////////////////
+		/// @returns float: Thickness of MultiGraph outline.
+		///////////////////////////////////////////////////////////
+		virtual float getOutlineThickness() const;
+		///////////////////////////////////////////////////////////
+		/// @returns Color: Color of MultiGraph outline.
+		///////////////////////////////////////////////////////////
+		virtual Color getOutlineColor() const;
+		///////////////////////////////////////////////////////////
+		/// @returns float: Radius of points.
+		///////////////////////////////////////////////////////////
+		virtual float getPointThickness() const;
+	protected:
+		///////////////////////////////////////////////////////////
+		/// struct Series is a protected struct storing one line of
+		/// the MultiGraph.
+		///////////////////////////////////////////////////////////
+		struct Series {
+			/// Points of the series.
+			util::RingBuffer<float> points;
+			/// Minimum and maximum of points.
+			util::SlidingExtrema<float> extrema;
+			/// Color of the line and points.
+			Color color;
+		};
+
+		/// Every series.
+		vector<Series> series;
+		/// Maximum number of points allowed on the x axis.
+		size_t numOfPoints = 20;
+		/// Viewing bounds.
+		float lowerBound = 0.0f, upperBound = 0.0f;
+		/// Automatically adjust bounds?
+		bool autoAdjustLower = false, autoAdjustUpper = false;
+		/// Color of the background of the MultiGraph.
+		Color backGroundColor;
+		/// Color of MultiGraph outline.
+		Color outlineColor;
+		/// Thickness of MultiGraph outline.
+		float outlineThickness;
+		/// Thickness of points.
+		float pointThickness;
+		/// Texture used to render every series onto.
+		sf::RenderTexture graphTexture;
+		/// Sprite used to move MultiGraph.
+		Sprite graphSprite;
+		/// Line segments of every series.
+		sf::VertexArray lineVertices;
+		/// Triangles of the point markers of every series.
+		sf::VertexArray pointVertices;
+		/// Positions of one series while its vertices are generated.
+		sf::VertexArray seriesVertices;
+		/// True if the points, bounds, size or colors changed since the
+		/// vertices were generated.
+		bool verticesStale = true;
+		/// Bumped by every change to what the texture shows.
+		uint64_t generation = 1;
+		/// Generation the texture was last drawn at.
+		uint64_t drawnGeneration = 0;
+
+		///////////////////////////////////////////////////////////
+		/// Method generateHitbox() is a private method that will
+		/// update the internal Hitbox to match the current object.
+		///////////////////////////////////////////////////////////
+		virtual void generateHitbox() override;
+		///////////////////////////////////////////////////////////
+		/// Method updateTexture() is a private method that will
+		/// redraw every series onto graphTexture.
+		///////////////////////////////////////////////////////////
+		virtual void updateTexture();
+		///////////////////////////////////////////////////////////
+		/// Method generateVertices() is a private method that will
+		/// rebuild lineVertices and pointVertices from every
+		/// series.
+		///////////////////////////////////////////////////////////
+		virtual void generateVertices();
+		///////////////////////////////////////////////////////////
+		/// Method invalidate() is a private method that will make
+		/// the next render rebuild the vertices and texture.
+		/// @param Dirty flags: Parts that changed.
+		///////////////////////////////////////////////////////////
+		void invalidate(Dirty flags);
+	};
+
+	///////////////////////////////////////////////////////////
+	/// Function draw() will render the MultiGraph object to a
+	/// sf::RenderTarget.
+	/// @param sf::RenderTarget* target: Pointer to the target
+	///  you want to render. Example: &window.
+	/// @param MultiGraph& graph: MultiGraph object reference.
+	/// @param sf::RenderStates: Used for advanced blending and
+	///  custom shaders. By default it is set to
+	///  sf::RenderStates::Default.
+	///////////////////////////////////////////////////////////
+	GLASS_EXPORT void draw(
+		sf::RenderTarget* target,
+		MultiGraph& graph,
+		sf::RenderStates renderStates = sf::RenderStates::Default
+	);
+
+	///////////////////////////////////////////////////////////
+	/// Function operator<<() will output basic information
+	/// about the MultiGraph object to the given std::ostream.
+	/// @param std::ostream& os: Base output stream.
+	/// @param const MultiGraph& graph: Reference to MultiGraph
+	///  object.
+	/// @returns std::ostream&: The modified output stream.
+	///////////////////////////////////////////////////////////
+	GLASS_EXPORT std::ostream& operator<<(std::ostream& os, const MultiGraph& graph);
+}
@@ -100,6 +100,12 @@ namespace gs {
             sf::RenderTarget* target,
             sf::RenderStates renderStates = sf::RenderStates::Default
         ) override;
+        ///////////////////////////////////////////////////////////
+        /// Method batch() will add the RoundedRectangle to a 
+        /// RenderBatch. 
+        /// @param RenderBatch& batch: Batch to add geometry to. 
+        ///////////////////////////////////////////////////////////
+        virtual void batch(RenderBatch& batch) override;
 
         ///////////////////////////////////////////////////////////
         /// Method setPosition() will set the position of the top 
@@ -48,6 +48,12 @@ namespace gs {
 			sf::RenderTarget* target,
 			sf::RenderStates renderStates = sf::RenderStates::Default
 		) override;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add the Slider geometry to a 
+		/// RenderBatch. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch) override;
 
 		///////////////////////////////////////////////////////////
 		/// Method setPosition() will set the position of the top 
@@ -207,6 +213,23 @@ namespace gs {
 		/// @returns bool: True if locked false if unlocked. 
 		/////////////////////////////////////////////////////////// 
 		virtual bool isLocked() const override;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if the Slider reacts to the mouse. 
+		///////////////////////////////////////////////////////////
+		virtual bool acceptsPointer() const override;
+		///////////////////////////////////////////////////////////
+		/// Method updatePointer() will pass the mouse state on to
+		/// the internal Button. This is called by Menu or by 
+		/// update() if the Slider isn't in a Menu. 
+		/// @param bool hovered: True if the mouse is over the 
+		///  Slider. 
+		///////////////////////////////////////////////////////////
+		virtual void updatePointer(bool hovered) override;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True since update() only changes the 
+		///  Slider and its internal Button. 
+		///////////////////////////////////////////////////////////
+		virtual bool isUpdateThreadSafe() const override;
 
 		///////////////////////////////////////////////////////////
 		/// @returns Vec2f: Size of Slider bar. 
@@ -0,0 +1,130 @@
+#pragma once
+
+// Dependencies
+#include "typedef.hpp"
+#include <unordered_map>
+
+namespace gs {
+	class Component;
+
+	namespace priv {
+		///////////////////////////////////////////////////////////
+		/// class SpatialGrid is a uniform grid used by Menu to
+		/// find the Components under a point without testing all
+		/// of them. Components are re-indexed lazily: they call
+		/// invalidate() when their Hitbox may have changed and are
+		/// moved to their new cells on the next refresh(). The 
+		/// owner of the grid is told right away so it can update 
+		/// anything derived from the Hitboxes. 
+		///////////////////////////////////////////////////////////
+		class GLASS_EXPORT SpatialGrid {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param float cellSize: Width and height of a cell in
+			///  pixels.
+			///////////////////////////////////////////////////////////
+			SpatialGrid(float cellSize = 64.0f);
+			~SpatialGrid();
+
+			///////////////////////////////////////////////////////////
+			/// Method setOwner() will set the Component that has its
+			/// Hitbox flagged as dirty whenever a Component in the 
+			/// grid is invalidated. 
+			/// @param Component* owner: Owner or nullptr for none. 
+			///////////////////////////////////////////////////////////
+			void setOwner(Component* owner);
+			///////////////////////////////////////////////////////////
+			/// Method setDeferred() will make invalidate() do nothing
+			/// so Components can be updated on several threads. The
+			/// caller has to invalidate the Components that changed
+			/// afterwards. 
+			/// @param bool deferred: True to ignore invalidate(). 
+			///////////////////////////////////////////////////////////
+			void setDeferred(bool deferred);
+
+			///////////////////////////////////////////////////////////
+			/// Method insert() will add a Component to the grid. Its
+			/// cells are computed on the next refresh().
+			/// @param Component* component: Component to add.
+			///////////////////////////////////////////////////////////
+			void insert(Component* component);
+			///////////////////////////////////////////////////////////
+			/// Method remove() will take a Component out of the grid.
+			/// @param Component* component: Component to remove.
+			///////////////////////////////////////////////////////////
+			void remove(Component* component);
+			///////////////////////////////////////////////////////////
+			/// Method invalidate() will queue a Component to have its
+			/// cells recomputed on the next refresh().
+			/// @param Component* component: Component that changed.
+			///////////////////////////////////////////////////////////
+			void invalidate(Component* component);
+			///////////////////////////////////////////////////////////
+			/// Method refresh() will move all of the queued
+			/// Components to the cells matching their Hitbox.
+			///////////////////////////////////////////////////////////
+			void refresh();
+			///////////////////////////////////////////////////////////
+			/// Method clear() will remove every Component.
+			///////////////////////////////////////////////////////////
+			void clear();
+
+			///////////////////////////////////////////////////////////
+			/// Method query() will collect the Components whose
+			/// bounds may contain a point. Note: Candidates still
+			/// need to be tested with Hitbox::intersects().
+			/// @param Vec2f point: Point to look up.
+			/// @param vector<Component*>& results: Output vector.
+			///  It is cleared first.
+			///////////////////////////////////////////////////////////
+			void query(Vec2f point, vector<Component*>& results) const;
+
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Number of Components in the grid.
+			///////////////////////////////////////////////////////////
+			size_t size() const;
+		protected:
+			///////////////////////////////////////////////////////////
+			/// struct Entry is a private struct storing where a
+			/// Component currently is in the grid.
+			///////////////////////////////////////////////////////////
+			struct Entry {
+				/// Range of cells covered. Inclusive.
+				int minx = 0, miny = 0, maxx = -1, maxy = -1;
+				/// True when stored in the oversized list instead of cells.
+				bool oversized = false;
+				/// True when queued for refresh().
+				bool pending = false;
+			};
+
+			/// Size of a cell in pixels.
+			float cellSize;
+			/// Told when a Component is invalidated.
+			Component* owner = nullptr;
+			/// True while invalidate() is ignored.
+			bool deferred = false;
+			/// Where each Component is.
+			std::unordered_map<Component*, Entry> entries;
+			/// Components in each cell keyed by packed cell coordinates.
+			std::unordered_map<long long, vector<Component*>> cells;
+			/// Components too big to be worth storing in cells.
+			vector<Component*> oversized;
+			/// Components waiting for refresh().
+			vector<Component*> pending;
+
+			///////////////////////////////////////////////////////////
+			/// Method unlink() will remove a Component from the cells
+			/// it currently occupies.
+			/// @param Component* component: Component to unlink.
+			/// @param Entry& entry: Entry of the Component.
+			///////////////////////////////////////////////////////////
+			void unlink(Component* component, Entry& entry);
+			///////////////////////////////////////////////////////////
+			/// @param int x: Cell x.
+			/// @param int y: Cell y.
+			/// @returns long long: Key of cell in cells map.
+			///////////////////////////////////////////////////////////
+			static long long cellKey(int x, int y);
+		};
+	}
+}
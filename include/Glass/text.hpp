@@ -2,8 +2,94 @@
 
 // Dependencies 
 #include "component.hpp"
+#include <memory>
 
 namespace gs {
+	namespace priv {
+		///////////////////////////////////////////////////////////
+		/// struct TextLayout is where the glyphs of a string go 
+		/// for one font, size, style and color. It is shared by 
+		/// every Text showing the same string. 
+		///////////////////////////////////////////////////////////
+		struct TextLayout {
+			///////////////////////////////////////////////////////////
+			/// struct Character is where the layout of a line was 
+			/// after a character. Everything is relative to the 
+			/// start of its line so editing one line doesn't touch 
+			/// the others. 
+			///////////////////////////////////////////////////////////
+			struct Character {
+				/// Pen position after the character. For a newline it is 
+				/// the width of the line. 
+				float x;
+				/// Number of glyph quads in the line up to here. 
+				size_t quadEnd;
+				/// Bounds of the line up to here. 
+				float minX, maxX, minY, maxY;
+			};
+			///////////////////////////////////////////////////////////
+			/// struct Line is where a line starts. 
+			///////////////////////////////////////////////////////////
+			struct Line {
+				size_t firstCharacter;
+				size_t firstQuad;
+			};
+
+			/// Glyph quads in local coordinates with texture coordinates 
+			/// into the font page, followed by underlines and strike 
+			/// throughs. 
+			vector<sf::Vertex> vertices;
+			/// Outline quads matching vertices. Empty without an outline. 
+			/// Drawn first so they are under the fill. 
+			vector<sf::Vertex> outlineVertices;
+			/// Number of glyph quads at the start of vertices. 
+			size_t glyphQuadCount = 0;
+			/// One entry per character of the string. 
+			vector<Character> characters;
+			/// One entry per line. 
+			vector<Line> lines;
+			/// Area covered by vertices. 
+			sf::FloatRect quadBounds;
+			/// Bounds of the glyphs. Same as sf::Text::getLocalBounds(). 
+			sf::FloatRect localBounds;
+		};
+
+		///////////////////////////////////////////////////////////
+		/// Function relayoutText() will update a layout after part
+		/// of the string of a sf::Text was replaced. Only the 
+		/// lines holding the new characters are laid out again. 
+		/// Lines after them are only moved down or up if the 
+		/// number of lines changed. An empty layout is laid out 
+		/// from scratch. 
+		/// @param TextLayout& layout: Layout of the old string. 
+		/// @param const sf::Text& text: Text holding the new 
+		///  string. 
+		/// @param size_t first: Index of first changed character. 
+		/// @param size_t oldEnd: One past the last changed 
+		///  character in the old string. 
+		/// @param size_t newEnd: One past the last changed 
+		///  character in the new string. 
+		/// @param sf::Color fillColor: Color of glyphs. 
+		/// @param sf::Color outlineColor: Color of outline. 
+		///////////////////////////////////////////////////////////
+		GLASS_EXPORT void relayoutText(
+			TextLayout& layout, const sf::Text& text,
+			size_t first, size_t oldEnd, size_t newEnd,
+			sf::Color fillColor, sf::Color outlineColor
+		);
+
+		///////////////////////////////////////////////////////////
+		/// Function layoutText() will return the layout of a 
+		/// sf::Text. Layouts are kept in a least recently used 
+		/// cache keyed by font, character size, style, spacing, 
+		/// colors and string so a string that was shown before 
+		/// isn't laid out again. Safe to call from any thread. 
+		/// @param const sf::Text& text: Text to lay out. 
+		/// @returns std::shared_ptr<const TextLayout>: Layout. 
+		///////////////////////////////////////////////////////////
+		GLASS_EXPORT std::shared_ptr<const TextLayout> layoutText(const sf::Text& text);
+	}
+
 	///////////////////////////////////////////////////////////
 	/// class Text is an sfml Text wrapper class. It is used 
 	/// for rendering text to the screen and can be added to a
@@ -36,6 +122,14 @@ namespace gs {
 			sf::RenderTarget* target,
 			sf::RenderStates renderStates = sf::RenderStates::Default
 		) override;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add the glyph quads of the Text to 
+		/// a RenderBatch. Texts with the same font and character 
+		/// size share a font page texture so any number of them 
+		/// are drawn in one call. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch) override;
 
 		///////////////////////////////////////////////////////////
 		/// Method setPosition() will set the position of the top 
@@ -132,6 +226,23 @@ namespace gs {
 		///////////////////////////////////////////////////////////  
 		virtual void setString(const std::string& string);
 		///////////////////////////////////////////////////////////
+		/// Method insertString() will insert characters into the 
+		/// string. Only the line they are added to is laid out 
+		/// again so typing costs the same no matter how long the 
+		/// string is. 
+		/// @param size_t position: Index to insert at. 
+		/// @param const std::string& string: Characters to insert. 
+		///////////////////////////////////////////////////////////  
+		virtual void insertString(size_t position, const std::string& string);
+		///////////////////////////////////////////////////////////
+		/// Method eraseString() will remove characters from the 
+		/// string. Only the line they are removed from is laid out
+		/// again. 
+		/// @param size_t position: Index of first character. 
+		/// @param size_t count: Number of characters. 
+		///////////////////////////////////////////////////////////  
+		virtual void eraseString(size_t position, size_t count);
+		///////////////////////////////////////////////////////////
 		/// Method setFillColor() will set the center color of the 
 		/// Text object. Note: To get a boarder first call 
 		/// setOutlineThickness() and the setOutlineColor() to 
@@ -256,9 +367,39 @@ namespace gs {
 		///////////////////////////////////////////////////////////
 		/// @returns sf::Text: Non-const reference of underlying
 		///  sf::Text object. Note: This can be used if a behaviour
-		///  is not implemented. 
+		///  is not implemented. The layout is found again on the next 
+		///  render since the text may be changed through it. 
 		///////////////////////////////////////////////////////////  
 		virtual sf::Text& getText();
+		///////////////////////////////////////////////////////////
+		/// Method findCharacterPos() will find where a character 
+		/// is drawn from the layout that is already kept, so it 
+		/// costs O(log lines). 
+		/// @param size_t index: Index of character. Past the end
+		///  of the string gives the end of the last line. 
+		/// @returns Vec2f: Top left of the character's place on 
+		///  its line in global coordinates. 
+		///////////////////////////////////////////////////////////  
+		virtual Vec2f findCharacterPos(size_t index) const;
+		///////////////////////////////////////////////////////////
+		/// @returns float: Height of a line of Text in global 
+		///  coordinates. 
+		///////////////////////////////////////////////////////////  
+		virtual float getLineHeight() const;
+
+		///////////////////////////////////////////////////////////
+		/// Method setLayoutCacheCapacity() will set how many 
+		/// layouts are shared between all Text objects. By default
+		/// it is set to 256. 
+		/// @param size_t capacity: Most layouts kept. 
+		///////////////////////////////////////////////////////////  
+		static void setLayoutCacheCapacity(size_t capacity);
+		///////////////////////////////////////////////////////////
+		/// Method clearLayoutCache() will forget every layout. 
+		/// Note: Layouts are found by the address of their font so 
+		/// call this after destroying a sf::Font that was used. 
+		///////////////////////////////////////////////////////////  
+		static void clearLayoutCache();
 	protected:
 		/// Underlying sf::Text object. 
 		sf::Text text;
@@ -268,12 +409,76 @@ namespace gs {
 		Vec2f shadowOffset;
 		/// Color of shadow. Translucent by default. 
 		Color shadowColor;
+		/// Layout of text in its colors. Shared with every Text showing 
+		/// the same thing until it is edited. Null when text changed 
+		/// since it was found. 
+		mutable std::shared_ptr<const priv::TextLayout> layout;
+		/// Same as layout once insertString() or eraseString() copied 
+		/// it to edit in place. Null while layout is shared. 
+		std::shared_ptr<priv::TextLayout> editedLayout;
+		/// Fill quads of layout in the shadow color. 
+		vector<sf::Vertex> shadowVertices;
+		/// True if layout or the shadow color changed since 
+		/// shadowVertices was filled. 
+		bool shadowStale = true;
+		/// Cached local bounds of the text. Valid while Dirty::Hitbox is clear. 
+		mutable sf::FloatRect localBounds;
 
 		///////////////////////////////////////////////////////////
 		/// Method generateHitbox() is a private method that will 
 		/// update the internal Hitbox to match the current object. 
 		///////////////////////////////////////////////////////////  
 		virtual void generateHitbox() override;
+		///////////////////////////////////////////////////////////
+		/// Method getLocalBounds() is a private method that will 
+		/// return the cached bounds of the text, measuring it and 
+		/// updating the Hitbox first if they are out of date. 
+		/// @returns const sf::FloatRect&: Local bounds of text. 
+		///////////////////////////////////////////////////////////  
+		const sf::FloatRect& getLocalBounds() const;
+		///////////////////////////////////////////////////////////
+		/// Method getLayout() is a private method that will return 
+		/// the layout of text, finding it in the cache first if 
+		/// it is out of date. 
+		/// @returns const priv::TextLayout&: Layout of text. 
+		///////////////////////////////////////////////////////////  
+		const priv::TextLayout& getLayout() const;
+		///////////////////////////////////////////////////////////
+		/// Method editLayout() is a private method that will 
+		/// return a layout only this Text uses, copying the shared 
+		/// one the first time. 
+		/// @returns priv::TextLayout&: Layout to edit. 
+		///////////////////////////////////////////////////////////  
+		priv::TextLayout& editLayout();
+		///////////////////////////////////////////////////////////
+		/// Method invalidateLayout() is a private method that will 
+		/// make the layout be found again before it is next used. 
+		///////////////////////////////////////////////////////////  
+		void invalidateLayout();
+		///////////////////////////////////////////////////////////
+		/// Method recolor() is a private method that will set the 
+		/// color of every fill or outline vertex of the edited 
+		/// layout. 
+		/// @param bool outline: True for outline vertices. 
+		///////////////////////////////////////////////////////////  
+		void recolor(bool outline);
+		///////////////////////////////////////////////////////////
+		/// Method updateShadow() is a private method that will 
+		/// refill shadowVertices if it is out of date. 
+		///////////////////////////////////////////////////////////  
+		void updateShadow();
+		///////////////////////////////////////////////////////////
+		/// Method addGlyphs() is a private method that will add 
+		/// glyph quads to a RenderBatch. 
+		/// @param RenderBatch& batch: Batch to add quads to. 
+		/// @param const sf::Transform& transform: Transform of 
+		///  quads. 
+		/// @param const vector<sf::Vertex>& source: Quads to add. 
+		///////////////////////////////////////////////////////////  
+		void addGlyphs(
+			RenderBatch& batch, const sf::Transform& transform,
+			const vector<sf::Vertex>& source
+		);
 	};
 
 	///////////////////////////////////////////////////////////
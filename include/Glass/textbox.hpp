@@ -2,11 +2,15 @@
 
 // Dependencies 
 #include "button.hpp"
+#include "util/gapBuffer.hpp"
 
 namespace gs {
 	///////////////////////////////////////////////////////////
 	/// class Textbox is a Button class is used for inputing 
-	/// data from the keyboard. 
+	/// data from the keyboard. Text is typed at a cursor that
+	/// can be moved with the arrow keys, Home and End. Holding
+	/// shift selects. The string is kept in a gap buffer so
+	/// edits at the cursor don't copy the rest of it. 
 	///////////////////////////////////////////////////////////
 	class GLASS_EXPORT Textbox : public Button {
 	public:
@@ -32,6 +36,25 @@ namespace gs {
 		/// the input namespace. 
 		///////////////////////////////////////////////////////////
 		virtual void update() override;
+		///////////////////////////////////////////////////////////
+		/// Method render() will render the Textbox with its 
+		/// selection and cursor to a sf::RenderTarget. 
+		/// @param sf::RenderTarget* target: Pointer to the target
+		///  you want to render. Example: &window. 
+		/// @param sf::RenderStates: Used for advanced blending and
+		///  custom shaders. By default it is set to
+		///  sf::RenderStates::Default. 
+		///////////////////////////////////////////////////////////
+		virtual void render(
+			sf::RenderTarget* target,
+			sf::RenderStates renderStates = sf::RenderStates::Default
+		) override;
+		///////////////////////////////////////////////////////////
+		/// Method batch() will add the Textbox geometry with its 
+		/// selection and cursor to a RenderBatch. 
+		/// @param RenderBatch& batch: Batch to add geometry to. 
+		///////////////////////////////////////////////////////////
+		virtual void batch(RenderBatch& batch) override;
 
 		///////////////////////////////////////////////////////////
 		/// Method setStoredString() will update the internal 
@@ -69,6 +92,46 @@ namespace gs {
 		///  false to disable. 
 		///////////////////////////////////////////////////////////
 		virtual void setActive(bool isActive);
+		///////////////////////////////////////////////////////////
+		/// Method setCursor() will move the cursor. 
+		/// @param size_t position: Index of character the cursor
+		///  is before. Clamped to the stored string. 
+		/// @param bool select: Set true to select from where the 
+		///  cursor was. False clears the selection. 
+		///////////////////////////////////////////////////////////
+		virtual void setCursor(size_t position, bool select = false);
+		///////////////////////////////////////////////////////////
+		/// Method selectAll() will select the whole stored string. 
+		///////////////////////////////////////////////////////////
+		virtual void selectAll();
+		///////////////////////////////////////////////////////////
+		/// Method insertAtCursor() will insert a string at the 
+		/// cursor, replacing the selection. It is cut short to 
+		/// fit the maximum input length. 
+		/// @param const std::string& string: String to insert. 
+		///////////////////////////////////////////////////////////
+		virtual void insertAtCursor(const std::string& string);
+		///////////////////////////////////////////////////////////
+		/// Method eraseAtCursor() will erase the selection or if 
+		/// nothing is selected one character next to the cursor. 
+		/// @param bool forward: Set true to erase the character 
+		///  after the cursor like Delete, false to erase the one 
+		///  before like Backspace. 
+		///////////////////////////////////////////////////////////
+		virtual void eraseAtCursor(bool forward = false);
+		///////////////////////////////////////////////////////////
+		/// Method setCursorColor() will set the color of the 
+		/// cursor. By default it is black. 
+		/// @param Color color: Cursor color. 
+		///////////////////////////////////////////////////////////
+		virtual void setCursorColor(Color color);
+		///////////////////////////////////////////////////////////
+		/// Method setSelectionColor() will set the color drawn 
+		/// over selected characters. By default it is a 
+		/// translucent blue. 
+		/// @param Color color: Selection color. 
+		///////////////////////////////////////////////////////////
+		virtual void setSelectionColor(Color color);
 
 		///////////////////////////////////////////////////////////
 		/// @returns const::string&: Reference to stored string. 
@@ -91,9 +154,40 @@ namespace gs {
 		///  inputed. 
 		///////////////////////////////////////////////////////////
 		virtual bool getActive() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Index of character the cursor is 
+		///  before. 
+		///////////////////////////////////////////////////////////
+		virtual size_t getCursor() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Index of first selected character. 
+		///////////////////////////////////////////////////////////
+		virtual size_t getSelectionStart() const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: One past the last selected character. 
+		///  Same as getSelectionStart() if nothing is selected. 
+		///////////////////////////////////////////////////////////
+		virtual size_t getSelectionEnd() const;
+		///////////////////////////////////////////////////////////
+		/// @returns Color: Color of cursor. 
+		///////////////////////////////////////////////////////////
+		virtual Color getCursorColor() const;
+		///////////////////////////////////////////////////////////
+		/// @returns Color: Color drawn over selected characters. 
+		///////////////////////////////////////////////////////////
+		virtual Color getSelectionColor() const;
 	protected:
-		/// String used for inputs. 
-		std::string storedString = "";
+		/// Characters used for inputs. 
+		util::GapBuffer<char> buffer;
+		/// Copy of buffer returned by getStoredString(). 
+		mutable std::string storedString = "";
+		/// True if buffer changed since storedString was copied. 
+		mutable bool storedStringStale = false;
+		/// Index of character the cursor is before. 
+		size_t cursor = 0;
+		/// Other end of the selection. Same as cursor if nothing is
+		/// selected. 
+		size_t selectionAnchor = 0;
 		/// String used for parsing purposes.  
 		std::string parsingString = "";
 		/// String used as display message.  
@@ -104,7 +198,30 @@ namespace gs {
 		int cursorTickSpeed = 50;
 		/// True if Textbox can have strings entered. 
 		bool isActive = false;
+		/// Ticks since the cursor was last shown or hidden. 
+		int tickCount = 0;
+		/// True if the blinking cursor is shown. 
+		bool cursorVisible = true;
+		/// Color of cursor. 
+		Color cursorColor = Color::Black;
+		/// Color drawn over selected characters. 
+		Color selectionColor = Color(51, 153, 255, 96);
+		/// Rectangles of the selection, one per line. Kept to reuse 
+		/// the storage. 
+		vector<sf::FloatRect> selectionRects;
 
     virtual void updateTextDisplay();
+    /// True if the Text object is showing the stored string. 
+    bool showsStoredString() const;
+    /// Replaces characters first to last of buffer with a string and 
+    /// puts the cursor after it. Only the changed line of the Text 
+    /// object is laid out again. 
+    void replaceRange(size_t first, size_t last, const std::string& string);
+    /// Shows the cursor and restarts its blinking. Called when it moves. 
+    void resetBlink();
+    /// Fills selectionRects from the layout of the Text object. 
+    void findSelectionRects();
+    /// Finds where the cursor is drawn. False if it is hidden. 
+    bool findCursorRect(sf::FloatRect& rect) const;
 	};
 }
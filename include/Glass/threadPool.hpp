@@ -0,0 +1,127 @@
+#pragma once
+
+// Dependencies
+#include "typedef.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace gs {
+	namespace priv {
+		///////////////////////////////////////////////////////////
+		/// class ThreadPool runs loops over a range of indices on
+		/// a fixed set of worker threads. Every thread starts with
+		/// an equal share of the range and takes small chunks from
+		/// the front of it. Threads that run out steal half of
+		/// what is left from the back of another thread's share
+		/// so uneven work still keeps every thread busy.
+		///////////////////////////////////////////////////////////
+		class GLASS_EXPORT ThreadPool {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t threadCount: Number of worker threads.
+			///  The thread calling parallelFor() also does work. If
+			///  0 it is set to one less than the number of cores.
+			///////////////////////////////////////////////////////////
+			ThreadPool(size_t threadCount = 0);
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			///////////////////////////////////////////////////////////
+			/// Method parallelFor() will call a task once for every
+			/// index in [0, count) and return once all of them are
+			/// done. Note: If called from inside of a task or while
+			/// another thread is using the pool the loop is run on
+			/// the calling thread instead.
+			/// @param size_t count: Number of indices.
+			/// @param size_t grainSize: Number of indices a thread
+			///  takes at once.
+			/// @param const std::function<void(size_t)>& task: Task
+			///  to run. Must not throw.
+			///////////////////////////////////////////////////////////
+			void parallelFor(
+				size_t count, size_t grainSize,
+				const std::function<void(size_t)>& task
+			);
+
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Number of worker threads.
+			///////////////////////////////////////////////////////////
+			size_t getThreadCount() const;
+
+			///////////////////////////////////////////////////////////
+			/// @returns ThreadPool&: Pool shared by Glass. It is
+			///  created the first time it is used.
+			///////////////////////////////////////////////////////////
+			static ThreadPool& getDefault();
+		protected:
+			///////////////////////////////////////////////////////////
+			/// struct Range is a private struct storing the part of
+			/// the loop a thread has left. The begin and end indices
+			/// are packed into one atomic so taking from the front
+			/// and stealing from the back can't overlap.
+			///////////////////////////////////////////////////////////
+			struct alignas(64) Range {
+				std::atomic<uint64_t> bounds{0};
+			};
+
+			/// Worker threads.
+			vector<std::thread> threads;
+			/// Share of the current loop of every thread. Index 0 is the caller.
+			std::unique_ptr<Range[]> ranges;
+			/// Task of the current loop.
+			const std::function<void(size_t)>* task = nullptr;
+			/// Chunk size of the current loop.
+			size_t grainSize = 1;
+			/// Bumped for every loop so workers know there is new work.
+			uint64_t loopId = 0;
+			/// Workers still running the current loop.
+			size_t runningWorkers = 0;
+			/// True when the destructor wants the workers to exit.
+			bool stopping = false;
+			/// True while a loop is running.
+			std::atomic<bool> busy{false};
+			/// Guards the members above.
+			std::mutex mutex;
+			/// Wakes workers when a loop starts.
+			std::condition_variable loopStarted;
+			/// Wakes the caller when the workers are done.
+			std::condition_variable loopFinished;
+
+			///////////////////////////////////////////////////////////
+			/// Method workerLoop() is run by each worker thread.
+			/// @param size_t index: Index of the worker's Range.
+			///////////////////////////////////////////////////////////
+			void workerLoop(size_t index);
+			///////////////////////////////////////////////////////////
+			/// Method runRanges() will run chunks of the current loop
+			/// until every Range is empty.
+			/// @param size_t index: Index of the thread's own Range.
+			///////////////////////////////////////////////////////////
+			void runRanges(size_t index);
+			///////////////////////////////////////////////////////////
+			/// Method takeFront() will take a chunk from the front of
+			/// a Range.
+			/// @param Range& range: Range to take from.
+			/// @param uint32_t& begin: Output first index.
+			/// @param uint32_t& end: Output one past last index.
+			/// @returns bool: False if the Range is empty.
+			///////////////////////////////////////////////////////////
+			bool takeFront(Range& range, uint32_t& begin, uint32_t& end);
+			///////////////////////////////////////////////////////////
+			/// Method stealBack() will take the back half of a Range.
+			/// @param Range& range: Range to steal from.
+			/// @param uint32_t& begin: Output first index.
+			/// @param uint32_t& end: Output one past last index.
+			/// @returns bool: False if the Range is empty.
+			///////////////////////////////////////////////////////////
+			bool stealBack(Range& range, uint32_t& begin, uint32_t& end);
+		};
+	}
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+// Dependencies
+#include "typedef.hpp"
+#include "util/mappedFile.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace gs {
+	///////////////////////////////////////////////////////////
+	/// class TimeSeriesFile reads a recorded capture of samples
+	/// straight from disk through a memory mapping, so captures
+	/// larger than memory can be browsed. Zoomed out views are
+	/// read from a min/max pyramid stored next to the capture
+	/// in a sidecar file. It is built on a background thread
+	/// the first time it is needed and reused as long as the
+	/// capture doesn't change.
+	///////////////////////////////////////////////////////////
+	class GLASS_EXPORT TimeSeriesFile {
+	public:
+		///////////////////////////////////////////////////////////
+		/// enum class Format is the layout of the records in a
+		/// capture. Float32 is a flat array of float values whose
+		/// time is their index. TimestampedFloat32 is packed 12
+		/// byte records of an int64 time then a float value,
+		/// sorted by time.
+		///////////////////////////////////////////////////////////
+		enum class Format { Float32, TimestampedFloat32 };
+
+		TimeSeriesFile();
+		~TimeSeriesFile();
+
+		///////////////////////////////////////////////////////////
+		/// Method open() will map a capture. The pyramid isn't
+		/// touched until it is needed.
+		/// @param const std::string& path: Path of capture.
+		/// @param Format format: Layout of the records.
+		/// @returns bool: False if the file couldn't be mapped.
+		///////////////////////////////////////////////////////////
+		bool open(const std::string& path, Format format);
+		///////////////////////////////////////////////////////////
+		/// Method close() will unmap the capture and pyramid. A
+		/// pyramid still being built is abandoned.
+		///////////////////////////////////////////////////////////
+		void close();
+		///////////////////////////////////////////////////////////
+		/// Method buildPyramid() will load the pyramid from the
+		/// sidecar file or build it if the sidecar is missing or
+		/// older than the capture, waiting until it is done. Use
+		/// it as a prepare step off the UI thread or at load.
+		/// @returns bool: False if there is no pyramid because
+		///  the sidecar couldn't be written.
+		///////////////////////////////////////////////////////////
+		bool buildPyramid();
+		///////////////////////////////////////////////////////////
+		/// Method startPyramid() will start loading or building
+		/// the pyramid on a background thread and return at once.
+		/// readEnvelope() calls it when it needs the pyramid.
+		/// Check hasPyramid() to know when it is ready.
+		///////////////////////////////////////////////////////////
+		void startPyramid();
+
+		///////////////////////////////////////////////////////////
+		/// Method findIndex() will find where a time is in the
+		/// capture.
+		/// @param int64_t time: Time to look for.
+		/// @returns size_t: Index of the first sample at or after
+		///  time.
+		///////////////////////////////////////////////////////////
+		size_t findIndex(int64_t time) const;
+		///////////////////////////////////////////////////////////
+		/// Method readValues() will copy values from the capture.
+		/// @param size_t first: Index of first sample.
+		/// @param size_t count: Number of samples.
+		/// @param float* output: Array of at least count values.
+		///////////////////////////////////////////////////////////
+		void readValues(size_t first, size_t count, float* output) const;
+		///////////////////////////////////////////////////////////
+		/// Method readEnvelope() will split samples into columns
+		/// and find the lowest and highest value of each one. It
+		/// reads the coarsest pyramid level that still has a few
+		/// blocks per column so the cost depends on the number of
+		/// columns and not samples. Partial blocks at the column
+		/// edges are read from finer levels so each column only
+		/// covers its own samples. Note: Until the pyramid is
+		/// ready wide columns are estimated from evenly spaced
+		/// samples, so read again once hasPyramid() is true.
+		/// @param size_t first: Index of first sample.
+		/// @param size_t last: One past index of last sample.
+		/// @param size_t columns: Number of columns.
+		/// @param float* output: Array of 2 * columns values. The
+		///  minimum and maximum of each column are written in
+		///  that order.
+		///////////////////////////////////////////////////////////
+		void readEnvelope(size_t first, size_t last, size_t columns, float* output);
+
+		///////////////////////////////////////////////////////////
+		/// @param size_t index: Index of sample.
+		/// @returns int64_t: Time of sample.
+		///////////////////////////////////////////////////////////
+		int64_t getTime(size_t index) const;
+		///////////////////////////////////////////////////////////
+		/// @param size_t index: Index of sample.
+		/// @returns float: Value of sample.
+		///////////////////////////////////////////////////////////
+		float getValue(size_t index) const;
+		///////////////////////////////////////////////////////////
+		/// @returns size_t: Number of samples in the capture.
+		///////////////////////////////////////////////////////////
+		size_t getSampleCount() const;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if a capture is open.
+		///////////////////////////////////////////////////////////
+		bool isOpen() const;
+		///////////////////////////////////////////////////////////
+		/// @returns bool: True if the pyramid is loaded.
+		///////////////////////////////////////////////////////////
+		bool hasPyramid() const;
+	protected:
+		///////////////////////////////////////////////////////////
+		/// struct Extremes is a protected struct storing one block
+		/// of a pyramid level.
+		///////////////////////////////////////////////////////////
+		struct Extremes {
+			float min, max;
+		};
+
+		/// Mapping of the capture.
+		util::MappedFile source;
+		/// Mapping of the sidecar file.
+		util::MappedFile pyramid;
+		/// Path of the capture.
+		std::string path;
+		/// Layout of the records.
+		Format format = Format::Float32;
+		/// Size of one record in bytes.
+		size_t recordSize = 4;
+		/// Number of samples.
+		size_t sampleCount = 0;
+		/// Start of each level in the sidecar. Level 0 is the finest.
+		vector<const Extremes*> levels;
+		/// Number of blocks in each level.
+		vector<size_t> levelSizes;
+		///////////////////////////////////////////////////////////
+		/// enum class PyramidState is how far the pyramid got.
+		/// levels and levelSizes are only read once it is Ready.
+		///////////////////////////////////////////////////////////
+		enum class PyramidState { None, Building, Ready, Failed };
+		std::atomic<PyramidState> pyramidState{ PyramidState::None };
+		/// Set to make the background build stop early.
+		std::atomic<bool> cancelPyramid{ false };
+		/// Thread loading or building the pyramid.
+		std::thread pyramidThread;
+
+		///////////////////////////////////////////////////////////
+		/// Method getBlockSize() will return how many samples a
+		/// block of a level covers.
+		/// @param size_t level: Pyramid level.
+		/// @returns size_t: Samples per block.
+		///////////////////////////////////////////////////////////
+		size_t getBlockSize(size_t level) const;
+		///////////////////////////////////////////////////////////
+		/// Method findExtremes() will find the lowest and highest
+		/// value of a range of samples. Whole blocks are read from
+		/// a pyramid level and the edges from finer levels, so it
+		/// reads O(fanout) blocks per level.
+		/// @param size_t begin: Index of first sample.
+		/// @param size_t end: One past index of last sample. Must
+		///  be more than begin.
+		/// @param size_t depth: Number of pyramid levels that may
+		///  be used. 0 reads samples only.
+		/// @returns Extremes: Lowest and highest value.
+		///////////////////////////////////////////////////////////
+		Extremes findExtremes(size_t begin, size_t end, size_t depth) const;
+		///////////////////////////////////////////////////////////
+		/// Method findLevels() will fill levels and levelSizes for
+		/// a mapped sidecar.
+		/// @returns uint64_t: Size the sidecar should be in bytes.
+		///////////////////////////////////////////////////////////
+		uint64_t findLevels();
+		///////////////////////////////////////////////////////////
+		/// Method loadPyramid() will load or build the pyramid.
+		/// Runs on pyramidThread or the thread calling
+		/// buildPyramid().
+		/// @returns bool: False if it couldn't be built.
+		///////////////////////////////////////////////////////////
+		bool loadPyramid();
+		///////////////////////////////////////////////////////////
+		/// Method getSourceVersion() will identify the current
+		/// version of the capture so a stale sidecar is noticed.
+		/// @returns int64_t: Last write time of the capture.
+		///////////////////////////////////////////////////////////
+		int64_t getSourceVersion() const;
+	};
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+// Dependencies
+#include "../typedef.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace gs {
+	namespace util {
+		namespace priv {
+			///////////////////////////////////////////////////////////
+			/// Function roundCapacity() will round a queue capacity up
+			/// to a power of two so indices can be wrapped with a mask.
+			/// @param size_t capacity: Requested capacity.
+			/// @returns size_t: Power of two of at least capacity.
+			///////////////////////////////////////////////////////////
+			inline size_t roundCapacity(size_t capacity) {
+				size_t rounded = 1;
+				while (rounded < capacity) {
+					rounded <<= 1;
+				}
+				return rounded;
+			}
+		}
+
+		///////////////////////////////////////////////////////////
+		/// class SpscQueue is a fixed capacity queue for passing
+		/// values from one producer thread to one consumer thread.
+		/// Both sides are wait-free: neither ever blocks or spins
+		/// on the other. When full push() fails instead of
+		/// overwriting.
+		///////////////////////////////////////////////////////////
+		template <typename Type>
+		class SpscQueue {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t capacity: Maximum number of queued
+			///  values. Rounded up to a power of two.
+			///////////////////////////////////////////////////////////
+			SpscQueue(size_t capacity)
+				: values(priv::roundCapacity(capacity)), mask(values.size() - 1) {}
+
+			SpscQueue(const SpscQueue&) = delete;
+			SpscQueue& operator=(const SpscQueue&) = delete;
+
+			///////////////////////////////////////////////////////////
+			/// Method push() will add a value to the back of the
+			/// queue. Only call it from the producer thread.
+			/// @param const Type& value: Value to add.
+			/// @returns bool: False if the queue was full.
+			///////////////////////////////////////////////////////////
+			bool push(const Type& value) {
+				size_t back = tail.load(std::memory_order_relaxed);
+				if (back - cachedHead == values.size()) {
+					cachedHead = head.load(std::memory_order_acquire);
+					if (back - cachedHead == values.size()) return false;
+				}
+				values[back & mask] = value;
+				tail.store(back + 1, std::memory_order_release);
+				return true;
+			}
+			///////////////////////////////////////////////////////////
+			/// Method pop() will remove values from the front of the
+			/// queue. Only call it from the consumer thread.
+			/// @param Type* output: Array to move values to.
+			/// @param size_t maxCount: Most values to remove.
+			/// @returns size_t: Number of values removed.
+			///////////////////////////////////////////////////////////
+			size_t pop(Type* output, size_t maxCount) {
+				size_t front = head.load(std::memory_order_relaxed);
+				if (cachedTail - front < maxCount) {
+					cachedTail = tail.load(std::memory_order_acquire);
+				}
+				size_t count = std::min(cachedTail - front, maxCount);
+				for (size_t i = 0; i < count; ++i) {
+					output[i] = values[(front + i) & mask];
+				}
+				head.store(front + count, std::memory_order_release);
+				return count;
+			}
+
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Maximum number of queued values.
+			///////////////////////////////////////////////////////////
+			size_t capacity() const { return values.size(); }
+		private:
+			/// Storage. Its size is a power of two.
+			vector<Type> values;
+			/// Wraps indices into values.
+			size_t mask;
+			/// Index of the next value to pop. Written by the consumer.
+			alignas(64) std::atomic<size_t> head{0};
+			/// Consumer's copy of tail so it reads it less often.
+			size_t cachedTail = 0;
+			/// Index of the next value to push. Written by the producer.
+			alignas(64) std::atomic<size_t> tail{0};
+			/// Producer's copy of head so it reads it less often.
+			size_t cachedHead = 0;
+		};
+
+		///////////////////////////////////////////////////////////
+		/// class MpscQueue is a fixed capacity queue for passing
+		/// values from any number of producer threads to one
+		/// consumer thread. Each slot has a sequence number that
+		/// tells producers and the consumer whose turn it is so no
+		/// locks are needed. Producers only retry when another
+		/// producer claimed the same slot first. When full push()
+		/// fails instead of overwriting.
+		///////////////////////////////////////////////////////////
+		template <typename Type>
+		class MpscQueue {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t capacity: Maximum number of queued
+			///  values. Rounded up to a power of two.
+			///////////////////////////////////////////////////////////
+			MpscQueue(size_t capacity)
+				: cellCount(priv::roundCapacity(capacity)), mask(cellCount - 1),
+				  cells(new Cell[cellCount]) {
+				for (size_t i = 0; i < cellCount; ++i) {
+					cells[i].sequence.store(i, std::memory_order_relaxed);
+				}
+			}
+
+			MpscQueue(const MpscQueue&) = delete;
+			MpscQueue& operator=(const MpscQueue&) = delete;
+
+			///////////////////////////////////////////////////////////
+			/// Method push() will add a value to the back of the
+			/// queue. Safe to call from any thread.
+			/// @param const Type& value: Value to add.
+			/// @returns bool: False if the queue was full.
+			///////////////////////////////////////////////////////////
+			bool push(const Type& value) {
+				size_t back = tail.load(std::memory_order_relaxed);
+				Cell* cell;
+				while (true) {
+					cell = &cells[back & mask];
+					size_t sequence = cell->sequence.load(std::memory_order_acquire);
+					intptr_t turn = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(back);
+					if (turn == 0) {
+						// The slot is free, claim it.
+						if (tail.compare_exchange_weak(back, back + 1, std::memory_order_relaxed)) break;
+					} else if (turn < 0) {
+						// The consumer hasn't popped this slot yet.
+						return false;
+					} else {
+						// Another producer claimed it first.
+						back = tail.load(std::memory_order_relaxed);
+					}
+				}
+				cell->value = value;
+				cell->sequence.store(back + 1, std::memory_order_release);
+				return true;
+			}
+			///////////////////////////////////////////////////////////
+			/// Method pop() will remove values from the front of the
+			/// queue. Only call it from the consumer thread.
+			/// @param Type* output: Array to move values to.
+			/// @param size_t maxCount: Most values to remove.
+			/// @returns size_t: Number of values removed.
+			///////////////////////////////////////////////////////////
+			size_t pop(Type* output, size_t maxCount) {
+				size_t count = 0;
+				while (count < maxCount) {
+					Cell& cell = cells[head & mask];
+					if (cell.sequence.load(std::memory_order_acquire) != head + 1) break;
+					output[count++] = cell.value;
+					// Hand the slot back to producers one lap later.
+					cell.sequence.store(head + cellCount, std::memory_order_release);
+					++head;
+				}
+				return count;
+			}
+
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Maximum number of queued values.
+			///////////////////////////////////////////////////////////
+			size_t capacity() const { return cellCount; }
+		private:
+			///////////////////////////////////////////////////////////
+			/// struct Cell is a private struct storing one slot of
+			/// the queue.
+			///////////////////////////////////////////////////////////
+			struct Cell {
+				std::atomic<size_t> sequence{0};
+				Type value;
+			};
+
+			/// Number of cells. A power of two.
+			size_t cellCount;
+			/// Wraps indices into cells.
+			size_t mask;
+			/// Storage.
+			std::unique_ptr<Cell[]> cells;
+			/// Index of the next value to pop. Only used by the consumer.
+			alignas(64) size_t head = 0;
+			/// Index of the next slot to claim.
+			alignas(64) std::atomic<size_t> tail{0};
+		};
+	}
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+// Dependencies
+#include "../typedef.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace gs {
+	namespace util {
+		///////////////////////////////////////////////////////////
+		/// class GapBuffer is a growable array with a gap of unused
+		/// space kept where the last edit was. Inserting or erasing
+		/// at the gap is O(1) amortized. Editing somewhere else
+		/// first moves the gap there, which costs one memmove of
+		/// the values in between. This suits text being edited at
+		/// a cursor.
+		///////////////////////////////////////////////////////////
+		template <typename Type>
+		class GapBuffer {
+			static_assert(std::is_trivially_copyable<Type>::value,
+				"GapBuffer moves values with memmove");
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t capacity: Number of values to make room
+			///  for up front.
+			///////////////////////////////////////////////////////////
+			GapBuffer(size_t capacity = 16) : data(std::max<size_t>(capacity, 1)), gapEnd(data.size()) {}
+
+			///////////////////////////////////////////////////////////
+			/// Method insert() will insert values, moving the gap to
+			/// the position first if needed.
+			/// @param size_t position: Index to insert at.
+			/// @param const Type* values: Values to insert.
+			/// @param size_t valueCount: Number of values.
+			///////////////////////////////////////////////////////////
+			void insert(size_t position, const Type* values, size_t valueCount) {
+				if (valueCount == 0) return;
+				moveGap(position);
+				if (gapEnd - gapStart < valueCount) {
+					grow(size() + valueCount);
+				}
+				std::memcpy(data.data() + gapStart, values, valueCount * sizeof(Type));
+				gapStart += valueCount;
+			}
+			///////////////////////////////////////////////////////////
+			/// Method insert() will insert one value.
+			/// @param size_t position: Index to insert at.
+			/// @param Type value: Value to insert.
+			///////////////////////////////////////////////////////////
+			void insert(size_t position, Type value) {
+				insert(position, &value, 1);
+			}
+			///////////////////////////////////////////////////////////
+			/// Method erase() will remove values by widening the gap
+			/// over them.
+			/// @param size_t position: Index of first value.
+			/// @param size_t valueCount: Number of values.
+			///////////////////////////////////////////////////////////
+			void erase(size_t position, size_t valueCount) {
+				valueCount = std::min(valueCount, size() - std::min(position, size()));
+				if (valueCount == 0) return;
+				moveGap(position);
+				gapEnd += valueCount;
+			}
+			///////////////////////////////////////////////////////////
+			/// Method clear() will remove all of the values. The
+			/// storage is kept.
+			///////////////////////////////////////////////////////////
+			void clear() {
+				gapStart = 0;
+				gapEnd = data.size();
+			}
+			///////////////////////////////////////////////////////////
+			/// Method moveGap() will move the gap to an index so the
+			/// next edit there doesn't need to.
+			/// @param size_t position: Index of gap.
+			///////////////////////////////////////////////////////////
+			void moveGap(size_t position) {
+				position = std::min(position, size());
+				if (position < gapStart) {
+					size_t moved = gapStart - position;
+					std::memmove(data.data() + gapEnd - moved, data.data() + position, moved * sizeof(Type));
+					gapStart -= moved;
+					gapEnd -= moved;
+				} else if (position > gapStart) {
+					size_t moved = position - gapStart;
+					std::memmove(data.data() + gapStart, data.data() + gapEnd, moved * sizeof(Type));
+					gapStart += moved;
+					gapEnd += moved;
+				}
+			}
+
+			///////////////////////////////////////////////////////////
+			/// Method copyOut() will copy values into an array in
+			/// order using at most two memcpy calls.
+			/// @param Type* output: Array to copy to.
+			/// @param size_t first: Index of first value.
+			/// @param size_t valueCount: Number of values.
+			///////////////////////////////////////////////////////////
+			void copyOut(Type* output, size_t first, size_t valueCount) const {
+				if (valueCount == 0) return;
+				size_t beforeGap = first < gapStart ? std::min(valueCount, gapStart - first) : 0;
+				std::memcpy(output, data.data() + first, beforeGap * sizeof(Type));
+				std::memcpy(output + beforeGap, data.data() + (first + beforeGap - gapStart) + gapEnd,
+					(valueCount - beforeGap) * sizeof(Type));
+			}
+
+			///////////////////////////////////////////////////////////
+			/// @param size_t index: Index of value.
+			/// @returns const Type&: Value at index.
+			///////////////////////////////////////////////////////////
+			const Type& operator[](size_t index) const {
+				return data[index < gapStart ? index : index + gapEnd - gapStart];
+			}
+			///////////////////////////////////////////////////////////
+			/// @param size_t index: Index of value.
+			/// @returns Type&: Value at index.
+			///////////////////////////////////////////////////////////
+			Type& operator[](size_t index) {
+				return data[index < gapStart ? index : index + gapEnd - gapStart];
+			}
+
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Number of values.
+			///////////////////////////////////////////////////////////
+			size_t size() const { return data.size() - (gapEnd - gapStart); }
+			///////////////////////////////////////////////////////////
+			/// @returns bool: True if there are no values.
+			///////////////////////////////////////////////////////////
+			bool empty() const { return size() == 0; }
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Index the gap is at.
+			///////////////////////////////////////////////////////////
+			size_t getGapPosition() const { return gapStart; }
+		private:
+			/// Storage. Values before gapStart and from gapEnd on are
+			/// used.
+			vector<Type> data;
+			/// Range of unused storage.
+			size_t gapStart = 0, gapEnd;
+
+			///////////////////////////////////////////////////////////
+			/// Method grow() will at least double the storage and
+			/// widen the gap to match.
+			/// @param size_t needed: Number of values that must fit.
+			///////////////////////////////////////////////////////////
+			void grow(size_t needed) {
+				size_t capacity = std::max(needed, data.size() * 2);
+				size_t tail = data.size() - gapEnd;
+				vector<Type> resized(capacity);
+				std::memcpy(resized.data(), data.data(), gapStart * sizeof(Type));
+				std::memcpy(resized.data() + capacity - tail, data.data() + gapEnd, tail * sizeof(Type));
+				data.swap(resized);
+				gapEnd = capacity - tail;
+			}
+		};
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+// Dependencies
+#include "../typedef.hpp"
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace gs {
+	namespace util {
+		///////////////////////////////////////////////////////////
+		/// class LruCache maps keys to values and holds at most a
+		/// fixed number of them. When it is full the entry that
+		/// was used longest ago is removed. Entries are kept in a
+		/// list ordered by use and found through a hash map of
+		/// list iterators so find() and insert() are O(1).
+		///////////////////////////////////////////////////////////
+		template <typename Key, typename Value, typename Hash = std::hash<Key>>
+		class LruCache {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t capacity: Most entries kept.
+			///////////////////////////////////////////////////////////
+			LruCache(size_t capacity = 0) : capacity(capacity) {}
+
+			///////////////////////////////////////////////////////////
+			/// Method find() will look up a key and mark it as the
+			/// most recently used.
+			/// @param const Key& key: Key to look for.
+			/// @returns Value*: Pointer to the value or nullptr if the
+			///  key isn't cached. Note: It is only valid until the
+			///  next insert().
+			///////////////////////////////////////////////////////////
+			Value* find(const Key& key) {
+				auto found = index.find(key);
+				if (found == index.end()) return nullptr;
+				entries.splice(entries.begin(), entries, found->second);
+				return &found->second->second;
+			}
+			///////////////////////////////////////////////////////////
+			/// Method insert() will add or replace an entry, removing
+			/// the least recently used one if the cache is full.
+			/// @param const Key& key: Key of entry.
+			/// @param Value value: Value of entry.
+			/// @returns Value&: Reference to the stored value.
+			///////////////////////////////////////////////////////////
+			Value& insert(const Key& key, Value value) {
+				auto found = index.find(key);
+				if (found != index.end()) {
+					found->second->second = std::move(value);
+					entries.splice(entries.begin(), entries, found->second);
+					return found->second->second;
+				}
+				entries.emplace_front(key, std::move(value));
+				index.emplace(key, entries.begin());
+				trim();
+				return entries.front().second;
+			}
+			///////////////////////////////////////////////////////////
+			/// Method clear() will remove every entry.
+			///////////////////////////////////////////////////////////
+			void clear() {
+				index.clear();
+				entries.clear();
+			}
+			///////////////////////////////////////////////////////////
+			/// Method setCapacity() will change how many entries are
+			/// kept, removing the least recently used ones if there
+			/// are too many.
+			/// @param size_t capacity: Most entries kept.
+			///////////////////////////////////////////////////////////
+			void setCapacity(size_t capacity) {
+				this->capacity = capacity;
+				trim();
+			}
+
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Number of entries.
+			///////////////////////////////////////////////////////////
+			size_t size() const { return entries.size(); }
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Most entries kept.
+			///////////////////////////////////////////////////////////
+			size_t getCapacity() const { return capacity; }
+		private:
+			/// Entries ordered from most to least recently used.
+			std::list<std::pair<Key, Value>> entries;
+			/// Position of each key in entries.
+			std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator, Hash> index;
+			/// Most entries kept.
+			size_t capacity;
+
+			///////////////////////////////////////////////////////////
+			/// Method trim() will remove the least recently used
+			/// entries until the cache fits its capacity.
+			///////////////////////////////////////////////////////////
+			void trim() {
+				while (entries.size() > capacity) {
+					index.erase(entries.back().first);
+					entries.pop_back();
+				}
+			}
+		};
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+// Dependencies
+#include "../typedef.hpp"
+#include <cstdint>
+#include <string>
+
+namespace gs {
+	namespace util {
+		///////////////////////////////////////////////////////////
+		/// class MappedFile maps a file into memory. Pages are
+		/// only read from disk when they are touched and the OS
+		/// can drop them again under memory pressure, so files
+		/// much larger than memory can be read.
+		///////////////////////////////////////////////////////////
+		class GLASS_EXPORT MappedFile {
+		public:
+			MappedFile();
+			~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			///////////////////////////////////////////////////////////
+			/// Method open() will map an existing file read only.
+			/// @param const std::string& path: Path of file.
+			/// @returns bool: False if the file couldn't be mapped.
+			///////////////////////////////////////////////////////////
+			bool open(const std::string& path);
+			///////////////////////////////////////////////////////////
+			/// Method create() will create or overwrite a file of a
+			/// given size and map it for reading and writing.
+			/// @param const std::string& path: Path of file.
+			/// @param uint64_t size: Size of file in bytes.
+			/// @returns bool: False if the file couldn't be mapped.
+			///////////////////////////////////////////////////////////
+			bool create(const std::string& path, uint64_t size);
+			///////////////////////////////////////////////////////////
+			/// Method close() will unmap the file.
+			///////////////////////////////////////////////////////////
+			void close();
+
+			///////////////////////////////////////////////////////////
+			/// @returns const char*: Start of the file in memory.
+			///////////////////////////////////////////////////////////
+			const char* getData() const;
+			///////////////////////////////////////////////////////////
+			/// @returns char*: Start of the file in memory. Only
+			///  writable if the file was mapped with create().
+			///////////////////////////////////////////////////////////
+			char* getData();
+			///////////////////////////////////////////////////////////
+			/// @returns uint64_t: Size of the file in bytes.
+			///////////////////////////////////////////////////////////
+			uint64_t getSize() const;
+			///////////////////////////////////////////////////////////
+			/// @returns bool: True if a file is mapped.
+			///////////////////////////////////////////////////////////
+			bool isOpen() const;
+		protected:
+			/// Start of the mapping.
+			char* data = nullptr;
+			/// Size of the mapping in bytes.
+			uint64_t size = 0;
+		#ifdef _WIN32
+			/// Handles of the file and its mapping.
+			void* fileHandle = nullptr;
+			void* mappingHandle = nullptr;
+		#else
+			/// Descriptor of the open file.
+			int fileDescriptor = -1;
+		#endif
+
+			///////////////////////////////////////////////////////////
+			/// Method map() will map the open file.
+			/// @param bool writable: Map for writing too?
+			/// @returns bool: False on failure.
+			///////////////////////////////////////////////////////////
+			bool map(bool writable);
+		};
+	}
+}
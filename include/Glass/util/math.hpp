@@ -108,6 +108,16 @@ namespace gs {
         return gs::Vec2<Type>(polarCoordinate.x * std::cos(angle), polarCoordinate.x * std::sin(angle));
     }
 
+    // Unite function, smallest rectangle containing both rectangles
+    template <typename Type>
+    GLASS_EXPORT sf::Rect<Type> unite(sf::Rect<Type> r1, sf::Rect<Type> r2) {
+        Type left = std::min(r1.left, r2.left);
+        Type top = std::min(r1.top, r2.top);
+        Type right = std::max(r1.left + r1.width, r2.left + r2.width);
+        Type bottom = std::max(r1.top + r1.height, r2.top + r2.height);
+        return sf::Rect<Type>(left, top, right - left, bottom - top);
+    }
+
     // CartesianToPolar function
     template <typename Type>
     GLASS_EXPORT gs::Vec2<Type> cartesianToPolar(gs::Vec2<Type> cartesianCoordinate, bool inDegrees) {
@@ -0,0 +1,211 @@
+#pragma once
+
+// Dependencies
+#include "../typedef.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace gs {
+	namespace util {
+		///////////////////////////////////////////////////////////
+		/// class RingBuffer is a fixed capacity circular buffer.
+		/// Pushing past the capacity overwrites the oldest value
+		/// in O(1). Values are indexed in the order they were
+		/// pushed in: index 0 is the oldest.
+		///////////////////////////////////////////////////////////
+		template <typename Type>
+		class RingBuffer {
+			static_assert(std::is_trivially_copyable<Type>::value,
+				"RingBuffer copies values with memcpy");
+		public:
+			///////////////////////////////////////////////////////////
+			/// class ConstIterator walks the buffer from the oldest
+			/// value to the newest.
+			///////////////////////////////////////////////////////////
+			class ConstIterator {
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef Type value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef const Type* pointer;
+				typedef const Type& reference;
+
+				ConstIterator() : buffer(nullptr), index(0) {}
+				ConstIterator(const RingBuffer* buffer, size_t index)
+					: buffer(buffer), index(index) {}
+
+				reference operator*() const { return (*buffer)[index]; }
+				pointer operator->() const { return &(*buffer)[index]; }
+				ConstIterator& operator++() { ++index; return *this; }
+				ConstIterator operator++(int) { ConstIterator old = *this; ++index; return old; }
+				bool operator==(const ConstIterator& other) const { return index == other.index; }
+				bool operator!=(const ConstIterator& other) const { return index != other.index; }
+			private:
+				const RingBuffer* buffer;
+				size_t index;
+			};
+
+			///////////////////////////////////////////////////////////
+			/// @param size_t capacity: Maximum number of values.
+			///////////////////////////////////////////////////////////
+			RingBuffer(size_t capacity = 0) : data(capacity) {}
+
+			///////////////////////////////////////////////////////////
+			/// Method push() will add a value after the newest one.
+			/// If full the oldest value is overwritten.
+			/// @param Type value: Value to add.
+			///////////////////////////////////////////////////////////
+			void push(Type value) {
+				size_t capacity = data.size();
+				if (capacity == 0) return;
+				data[wrap(head + count)] = value;
+				if (count < capacity) {
+					++count;
+				} else {
+					head = wrap(head + 1);
+				}
+			}
+			///////////////////////////////////////////////////////////
+			/// Method push() will add many values at once. They are
+			/// copied in at most two memcpy calls.
+			/// @param const Type* values: Values to add, oldest
+			///  first.
+			/// @param size_t valueCount: Number of values.
+			///////////////////////////////////////////////////////////
+			void push(const Type* values, size_t valueCount) {
+				size_t capacity = data.size();
+				if (capacity == 0 || valueCount == 0) return;
+				if (valueCount >= capacity) {
+					// Only the newest values fit.
+					std::memcpy(data.data(), values + valueCount - capacity, capacity * sizeof(Type));
+					head = 0;
+					count = capacity;
+					return;
+				}
+
+				size_t tail = wrap(head + count);
+				size_t firstCount = std::min(valueCount, capacity - tail);
+				std::memcpy(data.data() + tail, values, firstCount * sizeof(Type));
+				std::memcpy(data.data(), values + firstCount, (valueCount - firstCount) * sizeof(Type));
+
+				count += valueCount;
+				if (count > capacity) {
+					head = wrap(head + count - capacity);
+					count = capacity;
+				}
+			}
+			///////////////////////////////////////////////////////////
+			/// Method clear() will remove all of the values.
+			///////////////////////////////////////////////////////////
+			void clear() {
+				head = 0;
+				count = 0;
+			}
+			///////////////////////////////////////////////////////////
+			/// Method setCapacity() will change the maximum number of
+			/// values. If it shrinks only the newest values are kept.
+			/// @param size_t capacity: New capacity.
+			///////////////////////////////////////////////////////////
+			void setCapacity(size_t capacity) {
+				if (capacity == data.size()) return;
+				size_t kept = std::min(count, capacity);
+				vector<Type> resized(capacity);
+				copyOut(resized.data(), count - kept, kept);
+				data.swap(resized);
+				head = 0;
+				count = kept;
+			}
+
+			///////////////////////////////////////////////////////////
+			/// Method copyOut() will copy values into an array in
+			/// order using at most two memcpy calls.
+			/// @param Type* output: Array to copy to.
+			/// @param size_t first: Index of first value.
+			/// @param size_t valueCount: Number of values.
+			///////////////////////////////////////////////////////////
+			void copyOut(Type* output, size_t first, size_t valueCount) const {
+				if (valueCount == 0) return;
+				size_t start = wrap(head + first);
+				size_t firstCount = std::min(valueCount, data.size() - start);
+				std::memcpy(output, data.data() + start, firstCount * sizeof(Type));
+				std::memcpy(output + firstCount, data.data(), (valueCount - firstCount) * sizeof(Type));
+			}
+
+			///////////////////////////////////////////////////////////
+			/// Method getContiguousCount() will return how many values
+			/// starting at an index are next to each other in memory.
+			/// Useful for running tight loops over the values.
+			/// @param size_t first: Index of first value.
+			/// @returns size_t: Values until the storage wraps
+			///  around. Can be more than there are values.
+			///////////////////////////////////////////////////////////
+			size_t getContiguousCount(size_t first) const {
+				return data.size() - wrap(head + first);
+			}
+
+			///////////////////////////////////////////////////////////
+			/// @param size_t index: Index of value. 0 is the oldest.
+			/// @returns const Type&: Value at index.
+			///////////////////////////////////////////////////////////
+			const Type& operator[](size_t index) const {
+				return data[wrap(head + index)];
+			}
+			///////////////////////////////////////////////////////////
+			/// @param size_t index: Index of value. 0 is the oldest.
+			/// @returns Type&: Value at index.
+			///////////////////////////////////////////////////////////
+			Type& operator[](size_t index) {
+				return data[wrap(head + index)];
+			}
+			///////////////////////////////////////////////////////////
+			/// @returns const Type&: Oldest value.
+			///////////////////////////////////////////////////////////
+			const Type& front() const {
+				return (*this)[0];
+			}
+			///////////////////////////////////////////////////////////
+			/// @returns const Type&: Newest value.
+			///////////////////////////////////////////////////////////
+			const Type& back() const {
+				return (*this)[count - 1];
+			}
+
+			ConstIterator begin() const { return ConstIterator(this, 0); }
+			ConstIterator end() const { return ConstIterator(this, count); }
+
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Number of values.
+			///////////////////////////////////////////////////////////
+			size_t size() const { return count; }
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Maximum number of values.
+			///////////////////////////////////////////////////////////
+			size_t capacity() const { return data.size(); }
+			///////////////////////////////////////////////////////////
+			/// @returns bool: True if there are no values.
+			///////////////////////////////////////////////////////////
+			bool empty() const { return count == 0; }
+			///////////////////////////////////////////////////////////
+			/// @returns bool: True if the next push() overwrites.
+			///////////////////////////////////////////////////////////
+			bool full() const { return count == data.size(); }
+		private:
+			/// Storage. Its size is the capacity.
+			vector<Type> data;
+			/// Index of the oldest value in data.
+			size_t head = 0;
+			/// Number of values stored.
+			size_t count = 0;
+
+			///////////////////////////////////////////////////////////
+			/// @param size_t index: Index in [0, 2 * capacity).
+			/// @returns size_t: Index wrapped into data.
+			///////////////////////////////////////////////////////////
+			size_t wrap(size_t index) const {
+				return index >= data.size() ? index - data.size() : index;
+			}
+		};
+	}
+}
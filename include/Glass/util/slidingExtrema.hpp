@@ -0,0 +1,125 @@
+#pragma once
+
+// Dependencies
+#include "../typedef.hpp"
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace gs {
+	namespace util {
+		///////////////////////////////////////////////////////////
+		/// class SlidingExtrema tracks the minimum and maximum of
+		/// the last few values pushed to it. Each extreme is kept
+		/// in a monotonic deque: a new value removes every value
+		/// it beats from the back since those can never be the
+		/// extreme again, and values that leave the window are
+		/// removed from the front. Each value is added and removed
+		/// once so push() is O(1) amortized and the getters are
+		/// O(1).
+		///////////////////////////////////////////////////////////
+		template <typename Type>
+		class SlidingExtrema {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t window: Number of newest values tracked.
+			///////////////////////////////////////////////////////////
+			SlidingExtrema(size_t window = 0) : window(window) {}
+
+			///////////////////////////////////////////////////////////
+			/// Method push() will add a value to the window. If the
+			/// window is full the oldest value leaves it.
+			/// @param Type value: Value to add.
+			///////////////////////////////////////////////////////////
+			void push(Type value) {
+				if (window == 0) return;
+				uint64_t index = pushed++;
+				while (!minimums.empty() && !(minimums.back().second < value)) {
+					minimums.pop_back();
+				}
+				minimums.emplace_back(index, value);
+				while (!maximums.empty() && !(value < maximums.back().second)) {
+					maximums.pop_back();
+				}
+				maximums.emplace_back(index, value);
+				evict();
+			}
+			///////////////////////////////////////////////////////////
+			/// Method push() will add many values at once. Values
+			/// that would leave the window straight away are skipped.
+			/// @param const Type* values: Values to add, oldest
+			///  first.
+			/// @param size_t count: Number of values.
+			///////////////////////////////////////////////////////////
+			void push(const Type* values, size_t count) {
+				size_t first = count > window ? count - window : 0;
+				pushed += first;
+				for (size_t i = first; i < count; ++i) {
+					push(values[i]);
+				}
+			}
+			///////////////////////////////////////////////////////////
+			/// Method clear() will remove all of the values.
+			///////////////////////////////////////////////////////////
+			void clear() {
+				minimums.clear();
+				maximums.clear();
+			}
+			///////////////////////////////////////////////////////////
+			/// Method setWindow() will change how many of the newest
+			/// values are tracked. Note: Growing the window does not
+			/// bring back values that already left it.
+			/// @param size_t window: New window size.
+			///////////////////////////////////////////////////////////
+			void setWindow(size_t window) {
+				this->window = window;
+				if (window == 0) {
+					clear();
+				} else {
+					evict();
+				}
+			}
+
+			///////////////////////////////////////////////////////////
+			/// @returns Type: Smallest value in the window. Only
+			///  valid if not empty().
+			///////////////////////////////////////////////////////////
+			Type getMin() const { return minimums.front().second; }
+			///////////////////////////////////////////////////////////
+			/// @returns Type: Largest value in the window. Only valid
+			///  if not empty().
+			///////////////////////////////////////////////////////////
+			Type getMax() const { return maximums.front().second; }
+			///////////////////////////////////////////////////////////
+			/// @returns bool: True if there are no values.
+			///////////////////////////////////////////////////////////
+			bool empty() const { return minimums.empty(); }
+			///////////////////////////////////////////////////////////
+			/// @returns size_t: Number of newest values tracked.
+			///////////////////////////////////////////////////////////
+			size_t getWindow() const { return window; }
+		private:
+			/// Candidates for the minimum, increasing from the front.
+			std::deque<std::pair<uint64_t, Type>> minimums;
+			/// Candidates for the maximum, decreasing from the front.
+			std::deque<std::pair<uint64_t, Type>> maximums;
+			/// Number of newest values tracked.
+			size_t window;
+			/// Number of values pushed so far. Used as their index.
+			uint64_t pushed = 0;
+
+			///////////////////////////////////////////////////////////
+			/// Method evict() will remove candidates that are older
+			/// than the window.
+			///////////////////////////////////////////////////////////
+			void evict() {
+				while (!minimums.empty() && minimums.front().first + window < pushed) {
+					minimums.pop_front();
+				}
+				while (!maximums.empty() && maximums.front().first + window < pushed) {
+					maximums.pop_front();
+				}
+			}
+		};
+	}
+}
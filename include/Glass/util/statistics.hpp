@@ -0,0 +1,257 @@
+#pragma once
+
+// Dependencies
+#include "../typedef.hpp"
+#include <cstdint>
+#include <deque>
+
+namespace gs {
+	namespace util {
+		///////////////////////////////////////////////////////////
+		/// struct Statistics is a summary of a set of values.
+		///////////////////////////////////////////////////////////
+		struct Statistics {
+			/// Number of values.
+			uint64_t count = 0;
+			/// Average of the values.
+			float mean = 0.0f;
+			/// Standard deviation of the values.
+			float standardDeviation = 0.0f;
+			/// Estimated 50th, 95th and 99th percentiles.
+			float p50 = 0.0f, p95 = 0.0f, p99 = 0.0f;
+		};
+
+		///////////////////////////////////////////////////////////
+		/// class RunningStats keeps the mean and variance of values
+		/// as they are added using Welford's method, which stays
+		/// accurate even when the values are large compared to how
+		/// much they vary. Two RunningStats can be merged exactly
+		/// and a value added before can be removed again.
+		///////////////////////////////////////////////////////////
+		class GLASS_EXPORT RunningStats {
+		public:
+			///////////////////////////////////////////////////////////
+			/// Method add() will add a value.
+			/// @param double value: Value to add.
+			///////////////////////////////////////////////////////////
+			void add(double value);
+			///////////////////////////////////////////////////////////
+			/// Method remove() will remove a value by running
+			/// Welford's method backwards.
+			/// @param double value: Value added before.
+			///////////////////////////////////////////////////////////
+			void remove(double value);
+			///////////////////////////////////////////////////////////
+			/// Method merge() will add every value of another
+			/// RunningStats.
+			/// @param const RunningStats& other: Values to add.
+			///////////////////////////////////////////////////////////
+			void merge(const RunningStats& other);
+			///////////////////////////////////////////////////////////
+			/// Method clear() will remove all of the values.
+			///////////////////////////////////////////////////////////
+			void clear();
+
+			///////////////////////////////////////////////////////////
+			/// @returns uint64_t: Number of values.
+			///////////////////////////////////////////////////////////
+			uint64_t getCount() const;
+			///////////////////////////////////////////////////////////
+			/// @returns double: Average of the values.
+			///////////////////////////////////////////////////////////
+			double getMean() const;
+			///////////////////////////////////////////////////////////
+			/// @returns double: Population variance of the values.
+			///////////////////////////////////////////////////////////
+			double getVariance() const;
+		private:
+			/// Number of values.
+			uint64_t count = 0;
+			/// Average of the values.
+			double mean = 0.0;
+			/// Sum of squared distances from the mean.
+			double squaredDistance = 0.0;
+		};
+
+		///////////////////////////////////////////////////////////
+		/// class QuantileSketch estimates quantiles of a stream of
+		/// values in a small fixed amount of memory using a KLL
+		/// sketch. Values are kept in levels where each value of
+		/// level h stands for 2^h values. When a level fills up it
+		/// is sorted and every other value is promoted to the next
+		/// level. Sketches can be merged, which is used to combine
+		/// parts of a stream.
+		///////////////////////////////////////////////////////////
+		class GLASS_EXPORT QuantileSketch {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t accuracy: Size of the top level. The
+			///  rank error is about 1.7 / accuracy.
+			///////////////////////////////////////////////////////////
+			QuantileSketch(size_t accuracy = 200);
+
+			///////////////////////////////////////////////////////////
+			/// Method add() will add a value.
+			/// @param float value: Value to add.
+			///////////////////////////////////////////////////////////
+			void add(float value);
+			///////////////////////////////////////////////////////////
+			/// Method merge() will add every value of another
+			/// sketch.
+			/// @param const QuantileSketch& other: Values to add.
+			///////////////////////////////////////////////////////////
+			void merge(const QuantileSketch& other);
+			///////////////////////////////////////////////////////////
+			/// Method clear() will remove all of the values.
+			///////////////////////////////////////////////////////////
+			void clear();
+
+			///////////////////////////////////////////////////////////
+			/// Method getQuantiles() will estimate several quantiles
+			/// at once.
+			/// @param const double* fractions: Quantiles to find in
+			///  increasing order. 0.5 is the median.
+			/// @param float* output: Array to write estimates to.
+			/// @param size_t count: Number of quantiles.
+			///////////////////////////////////////////////////////////
+			void getQuantiles(const double* fractions, float* output, size_t count) const;
+			///////////////////////////////////////////////////////////
+			/// @returns uint64_t: Number of values added.
+			///////////////////////////////////////////////////////////
+			uint64_t getCount() const;
+		private:
+			/// Values of each level. Level h values have weight 2^h.
+			vector<vector<float>> levels;
+			/// Size of the top level.
+			size_t accuracy;
+			/// Number of values added.
+			uint64_t count = 0;
+			/// State of the random bits used when compacting.
+			uint32_t seed = 0x9E3779B9u;
+
+			///////////////////////////////////////////////////////////
+			/// Method getCapacity() will return how many values a
+			/// level can hold. Lower levels hold fewer.
+			/// @param size_t level: Index of level.
+			/// @returns size_t: Capacity of level.
+			///////////////////////////////////////////////////////////
+			size_t getCapacity(size_t level) const;
+			///////////////////////////////////////////////////////////
+			/// Method compact() will promote half of every full level
+			/// to the next level.
+			///////////////////////////////////////////////////////////
+			void compact();
+		};
+
+		///////////////////////////////////////////////////////////
+		/// class StreamStatistics keeps Statistics of the newest
+		/// values of a stream and of every value ever added. The
+		/// count, mean and variance of the window are exact: the
+		/// owner of the values calls removeFromWindow() with each
+		/// value that leaves it. A sketch can't remove values so
+		/// the window is also split into blocks with their own
+		/// QuantileSketch. Full blocks that leave the window are
+		/// dropped and the rest are merged when the window
+		/// Statistics are asked for. Note: Window percentiles
+		/// cover up to an eighth of the window more values.
+		///////////////////////////////////////////////////////////
+		class GLASS_EXPORT StreamStatistics {
+		public:
+			///////////////////////////////////////////////////////////
+			/// @param size_t window: Number of newest values in the
+			///  window.
+			///////////////////////////////////////////////////////////
+			StreamStatistics(size_t window);
+
+			///////////////////////////////////////////////////////////
+			/// Method add() will add a value. Once the window is full
+			/// remove the oldest value with removeFromWindow().
+			/// @param float value: Value to add.
+			///////////////////////////////////////////////////////////
+			void add(float value);
+			///////////////////////////////////////////////////////////
+			/// Method add() will add many values at once.
+			/// @param const float* values: Values to add, oldest
+			///  first.
+			/// @param size_t count: Number of values.
+			///////////////////////////////////////////////////////////
+			void add(const float* values, size_t count);
+			///////////////////////////////////////////////////////////
+			/// Method addToWindow() will add a value to the window 
+			/// without counting it in the all time Statistics. Used 
+			/// to refill the window after setWindow().
+			/// @param float value: Value to add.
+			///////////////////////////////////////////////////////////
+			void addToWindow(float value);
+			///////////////////////////////////////////////////////////
+			/// Method removeFromWindow() will remove a value that has
+			/// left the window.
+			/// @param float value: Oldest value in the window.
+			///////////////////////////////////////////////////////////
+			void removeFromWindow(float value);
+			///////////////////////////////////////////////////////////
+			/// Method setWindow() will change the window size. The
+			/// window is emptied.
+			/// @param size_t window: New window size.
+			///////////////////////////////////////////////////////////
+			void setWindow(size_t window);
+			///////////////////////////////////////////////////////////
+			/// Method clearWindow() will empty the window but keep the
+			/// all time Statistics.
+			///////////////////////////////////////////////////////////
+			void clearWindow();
+			///////////////////////////////////////////////////////////
+			/// Method clear() will empty the window and all time
+			/// Statistics.
+			///////////////////////////////////////////////////////////
+			void clear();
+
+			///////////////////////////////////////////////////////////
+			/// @returns const Statistics&: Statistics of the window.
+			///////////////////////////////////////////////////////////
+			const Statistics& getWindowStatistics() const;
+			///////////////////////////////////////////////////////////
+			/// @returns const Statistics&: Statistics of every value.
+			///////////////////////////////////////////////////////////
+			const Statistics& getAllTimeStatistics() const;
+		private:
+			///////////////////////////////////////////////////////////
+			/// struct Block is a private struct storing part of the
+			/// window.
+			///////////////////////////////////////////////////////////
+			struct Block {
+				size_t count = 0;
+				QuantileSketch sketch;
+			};
+
+			/// Blocks of the window, oldest first.
+			std::deque<Block> blocks;
+			/// Number of newest values in the window.
+			size_t window;
+			/// Number of values per block.
+			size_t blockSize;
+			/// Number of values in blocks.
+			size_t windowCount = 0;
+			/// Values in the window.
+			RunningStats windowStats;
+			/// Every value ever added.
+			RunningStats allTimeStats;
+			QuantileSketch allTimeSketch;
+			/// Summaries kept until new values are added.
+			mutable Statistics windowStatistics, allTimeStatistics;
+			mutable bool windowStale = true, allTimeStale = true;
+
+			///////////////////////////////////////////////////////////
+			/// Method summarize() will fill Statistics from the merged
+			/// values.
+			/// @param const RunningStats& stats: Mean and variance.
+			/// @param const QuantileSketch& sketch: Quantiles.
+			/// @param Statistics& output: Statistics to fill.
+			///////////////////////////////////////////////////////////
+			static void summarize(
+				const RunningStats& stats, const QuantileSketch& sketch,
+				Statistics& output
+			);
+		};
+	}
+}
@@ -0,0 +1,233 @@
+#include "batch.hpp"
+#include "component.hpp"
+#include "util/math.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace gs {
+
+  namespace {
+    // How many Commands back findCommand() will look for a batch to merge into.
+    const size_t maxMergeDistance = 16;
+
+    bool overlaps(sf::FloatRect a, sf::FloatRect b) {
+      return a.left <= b.left + b.width && b.left <= a.left + a.width &&
+        a.top <= b.top + b.height && b.top <= a.top + a.height;
+    }
+
+    sf::Vertex* setQuad(sf::Vertex* vertices, Vec2f topLeft, Vec2f bottomRight, Color color) {
+      vertices[0] = sf::Vertex(topLeft, color);
+      vertices[1] = sf::Vertex(Vec2f(bottomRight.x, topLeft.y), color);
+      vertices[2] = sf::Vertex(Vec2f(topLeft.x, bottomRight.y), color);
+      vertices[3] = vertices[2];
+      vertices[4] = vertices[1];
+      vertices[5] = sf::Vertex(bottomRight, color);
+      return vertices + 6;
+    }
+  }
+
+  RenderBatch::RenderBatch() = default;
+
+  RenderBatch::~RenderBatch() = default;
+
+  void RenderBatch::clear() {
+    commandCount = 0;
+  }
+
+  void RenderBatch::draw(sf::RenderTarget* target, sf::RenderStates renderStates) {
+    drawCallCount = 0;
+    fallbackCount = 0;
+    for (size_t i = 0; i < commandCount; ++i) {
+      Command& command = commands[i];
+      switch (command.type) {
+        case Command::Type::Triangles: {
+          if (command.vertices.empty()) continue;
+          sf::RenderStates batchStates = renderStates;
+          batchStates.texture = command.texture;
+          batchStates.blendMode = command.blendMode;
+          target->draw(command.vertices.data(), command.vertices.size(), sf::Triangles, batchStates);
+          ++drawCallCount;
+          break;
+        }
+        case Command::Type::Drawable:
+          target->draw(*command.drawable, renderStates);
+          ++drawCallCount;
+          break;
+        case Command::Type::Component:
+          command.component->render(target, renderStates);
+          ++fallbackCount;
+          break;
+      }
+    }
+  }
+
+  sf::Vertex* RenderBatch::addTriangles(size_t vertexCount, sf::FloatRect bounds,
+    const sf::Texture* texture, sf::BlendMode blendMode) {
+    Command& command = findCommand(bounds, texture, blendMode);
+    size_t offset = command.vertices.size();
+    command.bounds = offset == 0 ? bounds : util::unite(command.bounds, bounds);
+    command.vertices.resize(offset + vertexCount);
+    return command.vertices.data() + offset;
+  }
+
+  void RenderBatch::addRectangle(Vec2f position, Vec2f size, Color color,
+    float outlineThickness, Color outlineColor) {
+    // Same as sf::RectangleShape a positive outline grows outwards and a
+    // negative outline is drawn inside of the rectangle.
+    Vec2f outerMin = position, outerMax = position + size;
+    Vec2f innerMin = outerMin, innerMax = outerMax;
+    if (outlineThickness > 0.0f) {
+      outerMin -= Vec2f(outlineThickness, outlineThickness);
+      outerMax += Vec2f(outlineThickness, outlineThickness);
+    } else {
+      innerMin -= Vec2f(outlineThickness, outlineThickness);
+      innerMax += Vec2f(outlineThickness, outlineThickness);
+    }
+
+    size_t vertexCount = outlineThickness != 0.0f ? 30 : 6;
+    sf::Vertex* vertices = addTriangles(vertexCount, sf::FloatRect(outerMin, outerMax - outerMin));
+    vertices = setQuad(vertices, position, position + size, color);
+
+    if (outlineThickness != 0.0f) {
+      vertices = setQuad(vertices, outerMin, Vec2f(outerMax.x, innerMin.y), outlineColor);
+      vertices = setQuad(vertices, Vec2f(outerMin.x, innerMax.y), outerMax, outlineColor);
+      vertices = setQuad(vertices, Vec2f(outerMin.x, innerMin.y), Vec2f(innerMin.x, innerMax.y), outlineColor);
+      setQuad(vertices, Vec2f(innerMax.x, innerMin.y), Vec2f(outerMax.x, innerMax.y), outlineColor);
+    }
+  }
+
+  void RenderBatch::addCircle(Vec2f position, float radius, Color color,
+    float outlineThickness, Color outlineColor, size_t pointCount) {
+    if (pointCount < 3) return;
+
+    Vec2f center = position + Vec2f(radius, radius);
+    float outerRadius = radius + std::max(outlineThickness, 0.0f);
+    float innerRadius = radius + std::min(outlineThickness, 0.0f);
+
+    size_t vertexCount = pointCount * (outlineThickness != 0.0f ? 9 : 3);
+    sf::Vertex* vertices = addTriangles(vertexCount, sf::FloatRect(
+      center - Vec2f(outerRadius, outerRadius), Vec2f(outerRadius, outerRadius) * 2.0f
+    ));
+
+    auto pointAt = [&center](size_t index, size_t count, float length) {
+      // Starts at the top of the circle like sf::CircleShape.
+      float angle = index * util::TAU / count - util::PI / 2.0f;
+      return center + Vec2f(std::cos(angle), std::sin(angle)) * length;
+    };
+
+    for (size_t i = 0; i < pointCount; ++i) {
+      *vertices++ = sf::Vertex(center, color);
+      *vertices++ = sf::Vertex(pointAt(i, pointCount, radius), color);
+      *vertices++ = sf::Vertex(pointAt(i + 1, pointCount, radius), color);
+    }
+
+    if (outlineThickness != 0.0f) {
+      for (size_t i = 0; i < pointCount; ++i) {
+        sf::Vertex inner0(pointAt(i, pointCount, innerRadius), outlineColor);
+        sf::Vertex inner1(pointAt(i + 1, pointCount, innerRadius), outlineColor);
+        sf::Vertex outer0(pointAt(i, pointCount, outerRadius), outlineColor);
+        sf::Vertex outer1(pointAt(i + 1, pointCount, outerRadius), outlineColor);
+        *vertices++ = inner0;
+        *vertices++ = outer0;
+        *vertices++ = inner1;
+        *vertices++ = inner1;
+        *vertices++ = outer0;
+        *vertices++ = outer1;
+      }
+    }
+  }
+
+  void RenderBatch::addSprite(const sf::Sprite& sprite, Color color, sf::BlendMode blendMode) {
+    const sf::Texture* texture = sprite.getTexture();
+    if (texture == nullptr) return;
+
+    sf::FloatRect local = sprite.getLocalBounds();
+    sf::IntRect textureRect = sprite.getTextureRect();
+    const sf::Transform& transform = sprite.getTransform();
+
+    float left = static_cast<float>(textureRect.left);
+    float top = static_cast<float>(textureRect.top);
+    float right = left + textureRect.width;
+    float bottom = top + textureRect.height;
+
+    sf::Vertex topLeft(transform.transformPoint(0.0f, 0.0f), color, Vec2f(left, top));
+    sf::Vertex topRight(transform.transformPoint(local.width, 0.0f), color, Vec2f(right, top));
+    sf::Vertex bottomLeft(transform.transformPoint(0.0f, local.height), color, Vec2f(left, bottom));
+    sf::Vertex bottomRight(transform.transformPoint(local.width, local.height), color, Vec2f(right, bottom));
+
+    sf::Vertex* vertices = addTriangles(6, sprite.getGlobalBounds(), texture, blendMode);
+    vertices[0] = topLeft;
+    vertices[1] = topRight;
+    vertices[2] = bottomLeft;
+    vertices[3] = bottomLeft;
+    vertices[4] = topRight;
+    vertices[5] = bottomRight;
+  }
+
+  void RenderBatch::addDrawable(const sf::Drawable& drawable, sf::FloatRect bounds) {
+    Command& command = nextCommand(Command::Type::Drawable);
+    command.drawable = &drawable;
+    command.bounds = bounds;
+  }
+
+  void RenderBatch::addComponent(Component* component) {
+    Command& command = nextCommand(Command::Type::Component);
+    command.component = component;
+    command.opaqueBounds = true;
+  }
+
+  size_t RenderBatch::getDrawCallCount() const {
+    return drawCallCount;
+  }
+
+  size_t RenderBatch::getFallbackCount() const {
+    return fallbackCount;
+  }
+
+  size_t RenderBatch::getVertexCount() const {
+    size_t vertexCount = 0;
+    for (size_t i = 0; i < commandCount; ++i) {
+      vertexCount += commands[i].vertices.size();
+    }
+    return vertexCount;
+  }
+
+  RenderBatch::Command& RenderBatch::findCommand(sf::FloatRect bounds,
+    const sf::Texture* texture, sf::BlendMode blendMode) {
+    // Walk backwards looking for a batch with the same state. Geometry can
+    // only be moved into it if nothing drawn after that batch overlaps it.
+    size_t searchEnd = commandCount > maxMergeDistance ? commandCount - maxMergeDistance : 0;
+    for (size_t i = commandCount; i-- > searchEnd;) {
+      Command& command = commands[i];
+      if (command.type == Command::Type::Triangles &&
+        command.texture == texture && command.blendMode == blendMode) {
+        return command;
+      }
+      if (command.opaqueBounds || overlaps(command.bounds, bounds)) {
+        break;
+      }
+    }
+
+    Command& command = nextCommand(Command::Type::Triangles);
+    command.texture = texture;
+    command.blendMode = blendMode;
+    return command;
+  }
+
+  RenderBatch::Command& RenderBatch::nextCommand(Command::Type type) {
+    if (commandCount == commands.size()) {
+      commands.emplace_back();
+    }
+    Command& command = commands[commandCount++];
+    command.type = type;
+    command.texture = nullptr;
+    command.blendMode = sf::BlendAlpha;
+    command.vertices.clear();
+    command.drawable = nullptr;
+    command.component = nullptr;
+    command.bounds = sf::FloatRect();
+    command.opaqueBounds = false;
+    return command;
+  }
+
+}
@@ -1,15 +1,20 @@
 #include "button.hpp"
+#include "input/mouse.hpp"
 
 namespace gs {
 
   #include "util/output.hpp"
 
-  Button::Button() : isSelected(false), isClickedOn(false) {}
+  Button::Button() : isSelected(false), isClickedOn(false),
+    currentScaleModifier(1.0f), currentTextScaleModifier(1.0f) {}
 
   Button::~Button() {}
 
   void Button::update() {
     if (!isLocked()) {
+      if (!pointerRouted && eventTriggerer != EventTriggerer::None) {
+        updatePointer(getHitbox().intersects(input::mousePosition));
+      }
       updateColorAndScale();
     }
   }
@@ -37,6 +42,19 @@ namespace gs {
     text.render(target, renderStates);
   }
 
+  void Button::batch(RenderBatch& batch) {
+    if (renderMethod == RenderMethod::Basic) {
+      if (shape == Shape::Rectangle) {
+        batch.addRectangle(getPosition(), getSize(), currentColor, outlineThickness, outlineColor);
+      } else if (shape == Shape::Circle) {
+        batch.addCircle(getPosition(), getRadius(), currentColor, outlineThickness, outlineColor);
+      }
+    } else if (renderMethod == RenderMethod::Textured) {
+      sprite.batch(batch);
+    }
+    text.batch(batch);
+  }
+
   void Button::clearShapeColors() {
     inActiveFillColor = sf::Color::White;
     selectedFillColor = sf::Color::White;
@@ -103,7 +121,7 @@ namespace gs {
   }
 
   void Button::applyStyle(const Style& style) {
-    this->style = style;
+    Component::applyStyle(style);
   }
 
   void Button::lock() {
@@ -120,6 +138,7 @@ namespace gs {
       sprite.setScale(size.x / sprite.getTexture().getSize().x, 
                       size.y / sprite.getTexture().getSize().y);
     }
+    markDirty(Dirty::Geometry);
     generateHitbox();
   }
 
@@ -133,9 +152,26 @@ namespace gs {
       sprite.setScale(radius * 2 / sprite.getTexture().getSize().x, 
                       radius * 2 / sprite.getTexture().getSize().y);
     }
+    markDirty(Dirty::Geometry);
     generateHitbox();
   }
 
+  void Button::setString(const std::string& string) {
+    text.setString(string);
+    text.setPosition(getPosition() + textOffset);
+    markDirty(Dirty::Geometry);
+  }
+
+  void Button::insertString(size_t position, const std::string& string) {
+    text.insertString(position, string);
+    markDirty(Dirty::Geometry);
+  }
+
+  void Button::eraseString(size_t position, size_t count) {
+    text.eraseString(position, count);
+    markDirty(Dirty::Geometry);
+  }
+
   Vec2f Button::getPosition() const {
     return Component::getPosition();
   }
@@ -156,6 +192,21 @@ namespace gs {
     return Component::isLocked();
   }
 
+  bool Button::acceptsPointer() const {
+    return eventTriggerer != EventTriggerer::None && !isLocked();
+  }
+
+  void Button::updatePointer(bool hovered) {
+    isSelected = hovered;
+    if (eventTriggerer == EventTriggerer::MouseClick) {
+      isClickedOn = hovered && input::mouseClickL;
+    } else if (eventTriggerer == EventTriggerer::ActiveMouse) {
+      isClickedOn = hovered && input::activeMouseClickL;
+    } else {
+      isClickedOn = false;
+    }
+  }
+
   Vec2f Button::getSize() const {
     return virtualHitbox.getSize();
   }
@@ -171,30 +222,49 @@ namespace gs {
       hitbox.setRadius(virtualHitbox.getRadius() * currentScaleModifier);
     }
     hitbox.setPosition(getPosition());
+    if (shape == Shape::Circle) {
+      // Circle Hitboxes are positioned by their center.
+      hitbox.move(getRadius(), getRadius());
+    }
+    markDirty(Dirty::Hitbox);
   }
 
   void Button::updateColorAndScale(bool _customButton) {
     // Update color and scale based on button state
+    Color color, textColor;
+    float scaleModifier, textScaleModifier;
     if (isSelected && !isClickedOn) {
-      currentColor = selectedFillColor;
-      currentTextColor = selectedTextFillColor;
-      currentScaleModifier = selectedScaleModifier;
-      currentTextScaleModifier = selectedTextScaleModifier;
+      color = selectedFillColor;
+      textColor = selectedTextFillColor;
+      scaleModifier = selectedScaleModifier;
+      textScaleModifier = selectedTextScaleModifier;
     } else if (isClickedOn) {
-      currentColor = clickedFillColor;
-      currentTextColor = clickedTextFillColor;
-      currentScaleModifier = clickedScaleModifier;
-      currentTextScaleModifier = clickedTextScaleModifier;
+      color = clickedFillColor;
+      textColor = clickedTextFillColor;
+      scaleModifier = clickedScaleModifier;
+      textScaleModifier = clickedTextScaleModifier;
     } else {
-      currentColor = inActiveFillColor;
-      currentTextColor = inActiveTextFillColor;
-      currentScaleModifier = 1.0f;
-      currentTextScaleModifier = 1.0f;
+      color = inActiveFillColor;
+      textColor = inActiveTextFillColor;
+      scaleModifier = 1.0f;
+      textScaleModifier = 1.0f;
     }
 
+    // Nothing to do when the state is the same as last frame.
+    if (!isDirty(Dirty::Style) && color == currentColor && textColor == currentTextColor &&
+      scaleModifier == currentScaleModifier && textScaleModifier == currentTextScaleModifier) {
+      return;
+    }
+
+    currentColor = color;
+    currentTextColor = textColor;
+    currentScaleModifier = scaleModifier;
+    currentTextScaleModifier = textScaleModifier;
+
     text.setFillColor(currentTextColor);
     text.setScale(textScale.x * currentTextScaleModifier, textScale.y * currentTextScaleModifier);
 
+    markDirty(Dirty::Style);
     generateHitbox();
   }
 
@@ -1,37 +1,58 @@
 #include "component.hpp"
+#include "menu.hpp"
 #include "hitbox.hpp"
 #include "typedef.hpp"
 #include <SFML/Graphics/RenderStates.hpp>
 
 using namespace gs;
 
+void Component::batch(RenderBatch& batch) {
+  batch.addComponent(this);
+}
+
+bool Component::acceptsPointer() const {
+  return false;
+}
+
+void Component::updatePointer(bool hovered) {}
+
+bool Component::isUpdateThreadSafe() const {
+  return false;
+}
+
 void Component::setPosition(Vec2f position) {
   hitbox.setPosition(position);
+  markDirty(Dirty::Transform);
 }
 
 void Component::setPosition(float x, float y) {
   hitbox.setPosition(x, y);
+  markDirty(Dirty::Transform);
 }
 
 void Component::setCenter(Vec2f center) {
   hitbox.setCenter(center);
+  markDirty(Dirty::Transform);
 }
 
 void Component::setCenter(float x, float y) {
   hitbox.setCenter(x, y);
+  markDirty(Dirty::Transform);
 }
 
 void Component::move(Vec2f offset) {
-  menuOffset += offset;
+  hitbox.move(offset);
+  markDirty(Dirty::Transform);
 }
 
 void Component::move(float x, float y) {
-  menuOffset.x += x;
-  menuOffset.y += y;
+  hitbox.move(x, y);
+  markDirty(Dirty::Transform);
 }
 
 void Component::applyStyle(const Style& style) {
   this->style = style;
+  markDirty(Dirty::Style);
 }
 
 void Component::lock() {
@@ -61,3 +82,89 @@ const Style& Component::getStyle() {
 bool Component::isLocked() const {
   return locked;
 }
+
+sf::Transform Component::getLocalTransform() const {
+  return sf::Transform::Identity;
+}
+
+const sf::Transform& Component::getWorldTransform() const {
+  // Pulled from the parent instead of pushed to the children so moving a
+  // Menu doesn't touch anything below it until it is needed. 
+  if (parent != nullptr) {
+    const sf::Transform& parentTransform = parent->getWorldTransform();
+    if (isDirty(Dirty::World) || parentWorldVersion != parent->worldVersion) {
+      worldTransform = parentTransform * getLocalTransform();
+      parentWorldVersion = parent->worldVersion;
+      ++worldVersion;
+      clearDirty(Dirty::World);
+    }
+  } else if (isDirty(Dirty::World)) {
+    worldTransform = getLocalTransform();
+    ++worldVersion;
+    clearDirty(Dirty::World);
+  }
+  return worldTransform;
+}
+
+Menu* Component::getParent() const {
+  return parent;
+}
+
+void Component::setZIndex(int zIndex) {
+  if (zIndex == this->zIndex) return;
+  this->zIndex = zIndex;
+  markDirty(Dirty::Style);
+  if (parent != nullptr) {
+    parent->reorder(this);
+  }
+}
+
+int Component::getZIndex() const {
+  return zIndex;
+}
+
+void Component::setLayer(unsigned int layer) {
+  if (layer == this->layer) return;
+  this->layer = layer;
+  markDirty(Dirty::Style);
+  if (parent != nullptr) {
+    parent->reorder(this);
+  }
+}
+
+unsigned int Component::getLayer() const {
+  return layer;
+}
+
+void Component::markDirty(Dirty flags) {
+  dirtyFlags |= static_cast<unsigned int>(flags);
+  if ((static_cast<unsigned int>(flags) & static_cast<unsigned int>(Dirty::Transform)) != 0) {
+    dirtyFlags |= static_cast<unsigned int>(Dirty::World);
+  }
+  const unsigned int hitboxFlags = static_cast<unsigned int>(
+    Dirty::Transform | Dirty::Geometry | Dirty::Hitbox
+  );
+  if (spatialIndex != nullptr && (static_cast<unsigned int>(flags) & hitboxFlags) != 0) {
+    spatialIndex->invalidate(this);
+  }
+}
+
+void Component::clearDirty(Dirty flags) const {
+  dirtyFlags &= ~static_cast<unsigned int>(flags);
+}
+
+bool Component::isDirty(Dirty flags) const {
+  return (dirtyFlags & static_cast<unsigned int>(flags)) != 0;
+}
+
+bool Component::hasChanged() const {
+  return isDirty(Dirty::Visual);
+}
+
+void Component::setPointerRouted(bool routed) {
+  pointerRouted = routed;
+}
+
+bool Component::isPointerRouted() const {
+  return pointerRouted;
+}
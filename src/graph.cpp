@@ -1,5 +1,7 @@
 #include "graph.hpp"
 #include "hitbox.hpp"
+#include "timeSeries.hpp"
+#include "util/math.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -8,12 +10,112 @@ namespace gs {
   #include "util/output.hpp"
 
   namespace priv {
-    void renderLine(sf::RenderTarget* target, Vec2f p1, Vec2f p2, Color color) {
-      sf::Vertex line[] = {
-        sf::Vertex(sf::Vector2f(p1.x, p1.y), color),
-        sf::Vertex(sf::Vector2f(p2.x, p2.y), color)
-      };
-      target->draw(line, 2, sf::Lines);
+    void addMarkers(const sf::Vertex* vertices, size_t count, float radius, Color color,
+      sf::VertexArray& markers) {
+      // Number of sides of the polygon used for a marker. 
+      const size_t markerSides = 8;
+      if (radius <= 0 || count == 0) return;
+      Vec2f corners[markerSides];
+      for (size_t side = 0; side < markerSides; ++side) {
+        float angle = side * util::TAU / markerSides;
+        corners[side] = Vec2f(std::cos(angle), std::sin(angle)) * radius;
+      }
+      for (size_t point = 0; point < count; ++point) {
+        Vec2f center = vertices[point].position;
+        for (size_t side = 0; side < markerSides; ++side) {
+          markers.append(sf::Vertex(center, color));
+          markers.append(sf::Vertex(center + corners[side], color));
+          markers.append(sf::Vertex(center + corners[(side + 1) % markerSides], color));
+        }
+      }
+    }
+  }
+
+  namespace {
+    // Calls function with every run of points in [first, last) that is 
+    // contiguous in memory so the loops over them stay tight. 
+    template <typename Function>
+    void forEachRun(const util::RingBuffer<float>& points, size_t first, size_t last,
+      Function function) {
+      while (first < last) {
+        size_t count = std::min(points.getContiguousCount(first), last - first);
+        function(&points[first], first, count);
+        first += count;
+      }
+    }
+
+    // Keeps the lowest and highest point of every pixel column in the order 
+    // they were graphed. 
+    void decimateMinMax(const util::RingBuffer<float>& points, double xStep,
+      vector<size_t>& indices) {
+      size_t first = 0;
+      for (size_t column = 1; first < points.size(); ++column) {
+        size_t last = std::min(points.size(), static_cast<size_t>(std::ceil(column / xStep)));
+        if (last <= first) continue;
+
+        size_t minIndex = first, maxIndex = first;
+        float min = points[first], max = points[first];
+        forEachRun(points, first, last, [&](const float* values, size_t offset, size_t count) {
+          for (size_t i = 0; i < count; ++i) {
+            if (values[i] < min) {
+              min = values[i];
+              minIndex = offset + i;
+            }
+            if (values[i] > max) {
+              max = values[i];
+              maxIndex = offset + i;
+            }
+          }
+        });
+        indices.push_back(std::min(minIndex, maxIndex));
+        if (minIndex != maxIndex) {
+          indices.push_back(std::max(minIndex, maxIndex));
+        }
+        first = last;
+      }
+    }
+
+    // Largest-Triangle-Three-Buckets. The first and last points are always 
+    // kept and the rest are split into buckets. From each bucket the point 
+    // making the largest triangle with the point kept from the previous 
+    // bucket and the average of the next bucket is kept. 
+    void decimateLargestTriangle(const util::RingBuffer<float>& points, size_t threshold,
+      vector<size_t>& indices) {
+      size_t count = points.size();
+      double bucketSize = static_cast<double>(count - 2) / (threshold - 2);
+      size_t previous = 0;
+      indices.push_back(0);
+      for (size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+        size_t first = static_cast<size_t>(bucket * bucketSize) + 1;
+        size_t last = static_cast<size_t>((bucket + 1) * bucketSize) + 1;
+        size_t nextLast = std::min(count, static_cast<size_t>((bucket + 2) * bucketSize) + 1);
+
+        double sum = 0.0;
+        forEachRun(points, last, nextLast, [&](const float* values, size_t, size_t runCount) {
+          for (size_t i = 0; i < runCount; ++i) {
+            sum += values[i];
+          }
+        });
+        double averageX = (last + nextLast - 1) / 2.0;
+        double averageY = sum / (nextLast - last);
+
+        double previousX = static_cast<double>(previous);
+        double previousY = points[previous];
+        double largestArea = -1.0;
+        forEachRun(points, first, last, [&](const float* values, size_t offset, size_t runCount) {
+          for (size_t i = 0; i < runCount; ++i) {
+            // Twice the area, only the comparison matters. 
+            double area = std::abs((previousX - averageX) * (values[i] - previousY) -
+              (previousX - (offset + i)) * (averageY - previousY));
+            if (area > largestArea) {
+              largestArea = area;
+              previous = offset + i;
+            }
+          }
+        });
+        indices.push_back(previous);
+      }
+      indices.push_back(count - 1);
     }
   }
 
@@ -22,7 +124,12 @@ namespace gs {
       autoAdjustLower(false), autoAdjustUpper(false),
       backGroundColor(Color::White), lineColor(Color::Black),
       outlineColor(Color::Black), pointColor(Color::Red),
-      outlineThickness(1.0f), pointThickness(2.0f) {
+      outlineThickness(1.0f), pointThickness(2.0f),
+      bandColor(Color(0, 0, 255, 128)), frontTexture(&graphTexture),
+      lineVertices(sf::LineStrip), pointVertices(sf::Triangles),
+      bandVertices(sf::Lines) {
+    points.setCapacity(numOfPoints);
+    extrema.setWindow(numOfPoints);
     graphTexture.create(100, 100);
     graphSprite.setTexture(graphTexture.getTexture());
   }
@@ -31,57 +138,284 @@ namespace gs {
 
   void Graph::update() {
     if (isLocked()) return;
+    drainIngestQueue();
     
-    if (autoAdjustLower || autoAdjustUpper) {
-      auto [min, max] = std::minmax_element(points.begin(), points.end());
-      if (autoAdjustLower) lowerBound = *min;
-      if (autoAdjustUpper) upperBound = *max;
+    if ((autoAdjustLower || autoAdjustUpper) && !extrema.empty()) {
+      float min = extrema.getMin();
+      float max = extrema.getMax();
+      if (autoAdjustLower && lowerBound != min) {
+        lowerBound = min;
+        invalidate(Dirty::Geometry);
+      }
+      if (autoAdjustUpper && upperBound != max) {
+        upperBound = max;
+        invalidate(Dirty::Geometry);
+      }
     }
   }
 
   void Graph::render(sf::RenderTarget* target, sf::RenderStates renderStates) {
-    graphTexture.clear(backGroundColor);
+    updateTexture();
+    graphSprite.render(target, renderStates);
+  }
 
-    if (!points.empty()) {
-      float xStep = graphTexture.getSize().x / static_cast<float>(numOfPoints - 1);
-      float yScale = graphTexture.getSize().y / (upperBound - lowerBound);
+  void Graph::batch(RenderBatch& batch) {
+    updateTexture();
+    graphSprite.batch(batch);
+  }
 
-      for (size_t i = 1; i < points.size(); ++i) {
-        float x1 = (i - 1) * xStep;
-        float x2 = i * xStep;
-        float y1 = graphTexture.getSize().y - (points[i - 1] - lowerBound) * yScale;
-        float y2 = graphTexture.getSize().y - (points[i] - lowerBound) * yScale;
+  bool Graph::isUpdateThreadSafe() const {
+    return true;
+  }
 
-        priv::renderLine(&graphTexture, Vec2f(x1, y1), Vec2f(x2, y2), lineColor);
+  void Graph::updateTexture() {
+    // Nothing changed since the last frame so the texture is still right. 
+    if (generation == drawnGeneration) return;
+    drawnGeneration = generation;
 
-        if (pointThickness > 0) {
-          sf::CircleShape point(pointThickness);
-          point.setFillColor(pointColor);
-          point.setPosition(x2 - pointThickness, y2 - pointThickness);
-          graphTexture.draw(point);
-        }
+    if (!scrolling || redrawAll || !scrollTexture()) {
+      if (verticesStale) {
+        generateVertices();
+      }
+      frontTexture->clear(backGroundColor);
+      frontTexture->draw(lineVertices);
+      frontTexture->draw(pointVertices);
+      frontTexture->draw(bandVertices);
+      frontTexture->display();
+      scrollOffset = 0.0f;
+    }
+    redrawAll = false;
+    appendedPoints = 0;
+    drawnPointCount = points.size();
+    graphSprite.setTexture(frontTexture->getTexture());
+  }
+
+  bool Graph::scrollTexture() {
+    if (appendedPoints == 0) return true;
+    // Decimated points don't keep their positions from frame to frame. 
+    size_t threshold = 2 * graphTexture.getSize().x;
+    if (decimation != Decimation::None && points.size() > threshold) return false;
+    if (appendedPoints >= points.size()) return false;
+    // Bands move with every point so the old frame can't be kept. 
+    if (statistics && statisticBands) return false;
+
+    // Points that fell off the front move everything else left. The texture 
+    // can only move by whole pixels so the fraction left over is kept and 
+    // added to the new points instead. 
+    Vec2u size = graphTexture.getSize();
+    float xStep = size.x / static_cast<float>(numOfPoints - 1);
+    float yScale = size.y / (upperBound - lowerBound);
+    size_t removed = drawnPointCount + appendedPoints - points.size();
+    float shift = scrollOffset + removed * xStep;
+    float pixels = std::floor(shift);
+    if (pixels >= size.x) return false;
+    scrollOffset = shift - pixels;
+
+    sf::RenderTexture* backTexture = frontTexture == &graphTexture ? &scrollBuffer : &graphTexture;
+    if (backTexture->getSize() != size) {
+      backTexture->create(size.x, size.y);
+    }
+    sf::Sprite previous(frontTexture->getTexture());
+    previous.setPosition(-pixels, 0.0f);
+    backTexture->clear(backGroundColor);
+    backTexture->draw(previous, sf::BlendNone);
+
+    // Only the segments reaching the new points are drawn. The marker of 
+    // the point they start from is drawn again so it stays over the line 
+    // like in a full redraw, where the first point has no marker. 
+    size_t first = points.size() - appendedPoints - 1;
+    sf::VertexArray line(sf::LineStrip);
+    sf::VertexArray markers(sf::Triangles);
+    for (size_t i = first; i < points.size(); ++i) {
+      Vec2f position(i * xStep + scrollOffset, size.y - (points[i] - lowerBound) * yScale);
+      line.append(sf::Vertex(position, lineColor));
+    }
+    size_t skipped = first == 0 ? 1 : 0;
+    priv::addMarkers(&line[skipped], line.getVertexCount() - skipped, pointThickness, pointColor, markers);
+    backTexture->draw(line);
+    backTexture->draw(markers);
+    backTexture->display();
+
+    frontTexture = backTexture;
+    return true;
+  }
+
+  void Graph::generateVertices() {
+    verticesStale = false;
+    lineVertices.clear();
+    pointVertices.clear();
+    bandVertices.clear();
+    if (points.empty()) return;
+
+    float height = static_cast<float>(graphTexture.getSize().y);
+    float xStep = graphTexture.getSize().x / static_cast<float>(numOfPoints - 1);
+    float yScale = height / (upperBound - lowerBound);
+
+    // Points closer together than a pixel all land in the same column so 
+    // only about two of them per column are drawn. 
+    size_t threshold = 2 * graphTexture.getSize().x;
+    if (decimation != Decimation::None && threshold > 2 && points.size() > threshold) {
+      decimatedIndices.clear();
+      if (decimation == Decimation::MinMax) {
+        decimateMinMax(points, xStep, decimatedIndices);
+      } else {
+        decimateLargestTriangle(points, threshold, decimatedIndices);
+      }
+      lineVertices.resize(decimatedIndices.size());
+      for (size_t i = 0; i < decimatedIndices.size(); ++i) {
+        size_t index = decimatedIndices[i];
+        Vec2f position(index * xStep, height - (points[index] - lowerBound) * yScale);
+        lineVertices[i] = sf::Vertex(position, lineColor);
+      }
+    } else {
+      lineVertices.resize(points.size());
+      size_t i = 0;
+      for (float point : points) {
+        Vec2f position(i * xStep, height - (point - lowerBound) * yScale);
+        lineVertices[i++] = sf::Vertex(position, lineColor);
       }
     }
 
-    graphTexture.display();
-    graphSprite.setTexture(graphTexture.getTexture());
-    graphSprite.render(target, renderStates);
+    // The first point has no marker. 
+    if (lineVertices.getVertexCount() > 1) {
+      priv::addMarkers(&lineVertices[1], lineVertices.getVertexCount() - 1,
+        pointThickness, pointColor, pointVertices);
+    }
+
+    if (statistics && statisticBands) {
+      const util::Statistics& window = statistics->getWindowStatistics();
+      float width = static_cast<float>(graphTexture.getSize().x);
+      for (float value : { window.mean, window.p50, window.p95, window.p99 }) {
+        float y = height - (value - lowerBound) * yScale;
+        bandVertices.append(sf::Vertex(Vec2f(0.0f, y), bandColor));
+        bandVertices.append(sf::Vertex(Vec2f(width, y), bandColor));
+      }
+    }
   }
 
   void Graph::graph(float value) {
-    points.push_back(value);
-    if (points.size() > numOfPoints) {
-      points.erase(points.begin());
+    if (statistics) {
+      if (points.full()) {
+        statistics->removeFromWindow(points.front());
+      }
+      statistics->add(value);
+    }
+    points.push(value);
+    ++appendedPoints;
+    extrema.push(value);
+    // New points alone can be scrolled in so the texture isn't redrawn. 
+    verticesStale = true;
+    ++generation;
+    markDirty(Dirty::Geometry);
+  }
+
+  void Graph::graph(const float* values, size_t count) {
+    if (count == 0) return;
+    if (statistics) {
+      // Points pushed out of the buffer leave the window, as do values of 
+      // a batch too long to fit. 
+      size_t capacity = points.capacity();
+      size_t total = points.size() + count;
+      size_t evicted = total > capacity ? std::min(points.size(), total - capacity) : 0;
+      for (size_t i = 0; i < evicted; ++i) {
+        statistics->removeFromWindow(points[i]);
+      }
+      statistics->add(values, count);
+      for (size_t i = 0; i + capacity < count; ++i) {
+        statistics->removeFromWindow(values[i]);
+      }
+    }
+    points.push(values, count);
+    appendedPoints += count;
+    extrema.push(values, count);
+    // New points alone can be scrolled in so the texture isn't redrawn. 
+    verticesStale = true;
+    ++generation;
+    markDirty(Dirty::Geometry);
+  }
+
+  void Graph::setIngestQueue(size_t capacity, Producers producers) {
+    singleProducerQueue.reset();
+    multiProducerQueue.reset();
+    if (capacity == 0) return;
+    if (producers == Producers::Single) {
+      singleProducerQueue = std::make_unique<util::SpscQueue<Sample>>(capacity);
+    } else {
+      multiProducerQueue = std::make_unique<util::MpscQueue<Sample>>(capacity);
+    }
+  }
+
+  bool Graph::pushSample(float value, double time) {
+    Sample sample = { time, value };
+    bool queued = false;
+    if (singleProducerQueue) {
+      queued = singleProducerQueue->push(sample);
+    } else if (multiProducerQueue) {
+      queued = multiProducerQueue->push(sample);
     }
+    if (!queued) {
+      droppedSamples.fetch_add(1, std::memory_order_relaxed);
+    }
+    return queued;
+  }
+
+  void Graph::drainIngestQueue() {
+    size_t count = 0;
+    if (singleProducerQueue) {
+      drainedSamples.resize(singleProducerQueue->capacity());
+      count = singleProducerQueue->pop(drainedSamples.data(), drainedSamples.size());
+    } else if (multiProducerQueue) {
+      drainedSamples.resize(multiProducerQueue->capacity());
+      count = multiProducerQueue->pop(drainedSamples.data(), drainedSamples.size());
+      // Each producer's samples are in order but they interleave. 
+      std::stable_sort(drainedSamples.begin(), drainedSamples.begin() + count,
+        [](const Sample& a, const Sample& b) { return a.time < b.time; });
+    }
+    if (count == 0) return;
+
+    drainedValues.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      drainedValues[i] = drainedSamples[i].value;
+    }
+    graph(drainedValues.data(), count);
+  }
+
+  void Graph::graphRange(TimeSeriesFile& source, int64_t beginTime, int64_t endTime) {
+    size_t first = source.findIndex(beginTime);
+    size_t last = std::max(first, source.findIndex(endTime));
+    size_t columns = std::max(graphTexture.getSize().x, 1u);
+    if (last - first <= 2 * columns) {
+      rangeValues.resize(last - first);
+      source.readValues(first, rangeValues.size(), rangeValues.data());
+    } else {
+      rangeValues.resize(2 * columns);
+      source.readEnvelope(first, last, columns, rangeValues.data());
+    }
+    setPointCount(std::max<size_t>(rangeValues.size(), 2));
+    clear();
+    graph(rangeValues.data(), rangeValues.size());
   }
 
   void Graph::clear() {
     points.clear();
+    extrema.clear();
+    if (statistics) {
+      statistics->clearWindow();
+    }
+    invalidate(Dirty::Geometry);
+  }
+
+  void Graph::invalidate(Dirty flags) {
+    verticesStale = true;
+    redrawAll = true;
+    ++generation;
+    markDirty(flags);
   }
 
   void Graph::setPosition(Vec2f position) {
     graphSprite.setPosition(position);
     generateHitbox();
+    markDirty(Dirty::Transform);
   }
 
   void Graph::setPosition(float xpos, float ypos) {
@@ -100,6 +434,7 @@ namespace gs {
   void Graph::move(Vec2f offset) {
     graphSprite.move(offset);
     generateHitbox();
+    markDirty(Dirty::Transform);
   }
 
   void Graph::move(float offsetx, float offsety) {
@@ -124,8 +459,10 @@ namespace gs {
 
   void Graph::setSize(Vec2f size) {
     graphTexture.create(static_cast<unsigned int>(size.x), static_cast<unsigned int>(size.y));
+    frontTexture = &graphTexture;
     graphSprite.setTexture(graphTexture.getTexture(), true);
     generateHitbox();
+    invalidate(Dirty::Geometry);
   }
 
   void Graph::setSize(float width, float height) {
@@ -134,10 +471,12 @@ namespace gs {
 
   void Graph::setLowerBound(float height) {
     lowerBound = height;
+    invalidate(Dirty::Geometry);
   }
 
   void Graph::setUpperBound(float height) {
     upperBound = height;
+    invalidate(Dirty::Geometry);
   }
 
   void Graph::setLowerBoundAutoAdjust(bool enabled) {
@@ -150,35 +489,88 @@ namespace gs {
 
   void Graph::setPointCount(size_t numOfPoints) {
     this->numOfPoints = numOfPoints;
-    while (points.size() > numOfPoints) {
-      points.erase(points.begin());
+    points.setCapacity(numOfPoints);
+    extrema.setWindow(numOfPoints);
+    if (statistics) {
+      // The blocks of the window depend on its size so the points left are 
+      // added again. 
+      statistics->setWindow(numOfPoints);
+      for (float point : points) {
+        statistics->addToWindow(point);
+      }
     }
+    invalidate(Dirty::Geometry);
   }
 
   void Graph::setFillColor(Color color) {
     backGroundColor = color;
+    invalidate(Dirty::Style);
   }
 
   void Graph::setLineColor(Color color) {
     lineColor = color;
+    invalidate(Dirty::Style);
   }
 
   void Graph::setOutlineThickness(float thickness) {
     outlineThickness = thickness;
     graphSprite.setOutlineThickness(thickness);
+    markDirty(Dirty::Style);
   }
 
   void Graph::setPointThickness(float thickness) {
     pointThickness = thickness;
+    invalidate(Dirty::Style);
   }
 
   void Graph::setOutlineColor(Color color) {
     outlineColor = color;
     graphSprite.setOutlineColor(color);
+    markDirty(Dirty::Style);
   }
 
   void Graph::setPointColor(Color color) {
     pointColor = color;
+    invalidate(Dirty::Style);
+  }
+
+  void Graph::setScrolling(bool enabled) {
+    scrolling = enabled;
+    redrawAll = true;
+  }
+
+  void Graph::setStatistics(bool enabled) {
+    if (enabled == static_cast<bool>(statistics)) return;
+    if (enabled) {
+      statistics = std::make_unique<util::StreamStatistics>(numOfPoints);
+      for (float point : points) {
+        statistics->add(point);
+      }
+    } else {
+      statistics.reset();
+    }
+    invalidate(Dirty::Geometry);
+  }
+
+  void Graph::setStatisticBands(bool enabled) {
+    statisticBands = enabled;
+    invalidate(Dirty::Geometry);
+  }
+
+  void Graph::setBandColor(Color color) {
+    bandColor = color;
+    invalidate(Dirty::Style);
+  }
+
+  void Graph::resetStatistics() {
+    if (!statistics) return;
+    statistics->clear();
+    invalidate(Dirty::Geometry);
+  }
+
+  void Graph::setDecimation(Decimation decimation) {
+    this->decimation = decimation;
+    invalidate(Dirty::Geometry);
   }
 
   Vec2f Graph::getPosition() const {
@@ -249,6 +641,42 @@ namespace gs {
     return pointColor;
   }
 
+  Graph::Decimation Graph::getDecimation() const {
+    return decimation;
+  }
+
+  bool Graph::isScrolling() const {
+    return scrolling;
+  }
+
+  bool Graph::getStatistics() const {
+    return static_cast<bool>(statistics);
+  }
+
+  bool Graph::getStatisticBands() const {
+    return statisticBands;
+  }
+
+  Color Graph::getBandColor() const {
+    return bandColor;
+  }
+
+  util::Statistics Graph::getWindowStatistics() const {
+    return statistics ? statistics->getWindowStatistics() : util::Statistics();
+  }
+
+  util::Statistics Graph::getAllTimeStatistics() const {
+    return statistics ? statistics->getAllTimeStatistics() : util::Statistics();
+  }
+
+  uint64_t Graph::getDroppedSampleCount() const {
+    return droppedSamples.load(std::memory_order_relaxed);
+  }
+
+  void Graph::resetDroppedSampleCount() {
+    droppedSamples.store(0, std::memory_order_relaxed);
+  }
+
   void Graph::generateHitbox() {
     Hitbox newHitbox(Hitbox::Shape::Rectangle);
     newHitbox.setPosition(getPosition());
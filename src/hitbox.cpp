@@ -5,6 +5,8 @@
 
 using namespace gs;
 
+Hitbox::Hitbox() : Hitbox(Shape::Rectangle) {}
+
 Hitbox::Hitbox(Shape shape) {
   this->shape = shape;
   this->position = Vec2f(0.0f, 0.0f);
@@ -40,8 +42,8 @@ void Hitbox::setSize(Vec2f size) {
 }
 
 void Hitbox::setSize(float x, float y) {
-  this->position.x = x;
-  this->position.y = y;
+  this->size.x = x;
+  this->size.y = y;
 }
 
 void Hitbox::setRadius(float radius) {
@@ -87,6 +89,13 @@ Vec2f Hitbox::getCenter() const {
   return position;
 }
 
+sf::FloatRect Hitbox::getBounds() const {
+  if (shape == Shape::Rectangle) {
+    return sf::FloatRect(position, size);
+  }
+  return sf::FloatRect(position.x - radius, position.y - radius, radius * 2.0f, radius * 2.0f);
+}
+
 void draw(sf::RenderTarget* target, const Hitbox& hitbox, sf::RenderStates renderStates) {
   sf::RectangleShape shape;
   shape.setPosition(hitbox.getPosition().x, hitbox.getPosition().y);
@@ -28,6 +28,8 @@ namespace gs {
 
     // Initialize external variables from key.hpp
     unsigned int textUnicode = 0;
+    sf::Keyboard::Key keyPressed = sf::Keyboard::Unknown;
+    bool keyShift = false;
 
     void setWindow(sf::RenderWindow* window) {
       priv::internalWindow = window;
@@ -65,6 +67,8 @@ namespace gs {
       mouseClickM = false;
       mouseClickR = false;
       textUnicode = 0;
+      keyPressed = sf::Keyboard::Unknown;
+      keyShift = false;
     }
 
     void updateEvents(sf::Event& event) {
@@ -79,6 +83,11 @@ namespace gs {
           textUnicode = event.text.unicode;
           break;
 
+        case sf::Event::KeyPressed:
+          keyPressed = event.key.code;
+          keyShift = event.key.shift;
+          break;
+
         default:
           break;
       }
@@ -1,66 +1,296 @@
 #include "menu.hpp"
+#include "input/mouse.hpp"
+#include "util/math.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace gs {
   namespace priv {
     bool defaultMenuEnabled = true;
   }
 
+  namespace {
+    // Extra space around a Component Hitbox for outlines and shadows that
+    // stick out of it.
+    const float drawPadding = 8.0f;
+
+    // Components each thread takes at once when updating in parallel. Runs of
+    // thread safe Components shorter than this are updated serially.
+    const size_t updateGrainSize = 16;
+
+    // Up to this many reordered Components are moved by binary insertion.
+    const size_t insertionSortLimit = 8;
+
+    // Past this many damaged areas they are bucketed into tiles before being
+    // merged in pairs.
+    const size_t maxDamageRects = 32;
+
+    // Damaged areas are bucketed into this many tiles per side before being
+    // merged in pairs. Keeps the pairwise merging small when many change.
+    const size_t damageTiles = 4;
+
+    // Most passes of pairwise merging.
+    const size_t maxMergePasses = 4;
+
+    // The cache texture holds colors already multiplied by their alpha since
+    // it was drawn onto a transparent background. Blending it with
+    // sf::BlendAlpha would apply the alpha twice.
+    const sf::BlendMode cacheBlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha);
+
+    float area(const sf::FloatRect& rect) {
+      return rect.width * rect.height;
+    }
+
+    // Snaps a rectangle outwards to whole pixels and clips it to [0, size].
+    sf::FloatRect snap(sf::FloatRect rect, Vec2f size) {
+      float left = std::max(std::floor(rect.left), 0.0f);
+      float top = std::max(std::floor(rect.top), 0.0f);
+      float right = std::min(std::ceil(rect.left + rect.width), size.x);
+      float bottom = std::min(std::ceil(rect.top + rect.height), size.y);
+      return sf::FloatRect(left, top, std::max(right - left, 0.0f), std::max(bottom - top, 0.0f));
+    }
+
+    // Greedily merges rectangles whenever their union doesn't cover more
+    // pixels than drawing both of them separately would.
+    void mergeRects(vector<sf::FloatRect>& rects) {
+      // Too many to merge in pairs. Each joins the tile its center is in so
+      // at most damageTiles^2 are left, in O(n).
+      if (rects.size() > maxDamageRects) {
+        sf::FloatRect bounds = rects[0];
+        for (size_t i = 1; i < rects.size(); ++i) {
+          bounds = util::unite(bounds, rects[i]);
+        }
+        sf::FloatRect tiles[damageTiles * damageTiles];
+        bool used[damageTiles * damageTiles] = {};
+        for (const sf::FloatRect& rect : rects) {
+          float x = (rect.left + rect.width / 2.0f - bounds.left) / bounds.width;
+          float y = (rect.top + rect.height / 2.0f - bounds.top) / bounds.height;
+          size_t column = std::min(static_cast<size_t>(std::max(x, 0.0f) * damageTiles), damageTiles - 1);
+          size_t row = std::min(static_cast<size_t>(std::max(y, 0.0f) * damageTiles), damageTiles - 1);
+          size_t tile = row * damageTiles + column;
+          tiles[tile] = used[tile] ? util::unite(tiles[tile], rect) : rect;
+          used[tile] = true;
+        }
+        rects.clear();
+        for (size_t tile = 0; tile < damageTiles * damageTiles; ++tile) {
+          if (used[tile]) {
+            rects.push_back(tiles[tile]);
+          }
+        }
+      }
+
+      bool merged = true;
+      for (size_t pass = 0; merged && pass < maxMergePasses; ++pass) {
+        merged = false;
+        for (size_t i = 0; i < rects.size(); ++i) {
+          for (size_t j = i + 1; j < rects.size();) {
+            sf::FloatRect united = util::unite(rects[i], rects[j]);
+            if (area(united) <= area(rects[i]) + area(rects[j])) {
+              rects[i] = united;
+              rects[j] = rects.back();
+              rects.pop_back();
+              merged = true;
+            } else {
+              ++j;
+            }
+          }
+        }
+      }
+    }
+  }
+
   #include "util/output.hpp"
 
   Menu defaultMenu;
 
   Menu::Menu() {
     this->locked = false;
+    hitGrid.setOwner(this);
   }
 
-  Menu::~Menu() = default;
+  Menu::~Menu() {
+    for (auto& component : components) {
+      if (component.ptr->spatialIndex == &hitGrid) {
+        component.ptr->spatialIndex = nullptr;
+        component.ptr->setPointerRouted(false);
+      }
+      if (component.ptr->parent == this) {
+        component.ptr->parent = nullptr;
+        component.ptr->markDirty(Dirty::World);
+      }
+    }
+  }
 
   void Menu::update() {
     if (!locked) {
-      for (auto& component : components) {
-        component.ptr->update();
+      sortComponents();
+      updatePointers();
+      if (updateMethod == UpdateMethod::Serial) {
+        for (auto& component : components) {
+          component.ptr->update();
+        }
+        return;
+      }
+
+      // Components that aren't thread safe split the list into runs that are
+      // updated in parallel. They are updated in order between the runs so
+      // the result is the same as updating serially. 
+      size_t runStart = 0;
+      for (size_t i = 0; i <= components.size(); ++i) {
+        if (i < components.size() && components[i].ptr->isUpdateThreadSafe()) continue;
+        updateParallel(runStart, i);
+        if (i < components.size()) {
+          components[i].ptr->update();
+        }
+        runStart = i + 1;
       }
     }
   }
 
   void Menu::render(sf::RenderTarget* target, sf::RenderStates renderStates) {
-    for (auto& component : components) {
-      component.ptr->render(target, renderStates);
+    sortComponents();
+    renderStates.transform *= getLocalTransform();
+    if (isPartialRedraw() && renderDamage(target, renderStates)) {
+      // Drawn from the backbuffer. 
+    } else if (isCached() && updateCache()) {
+      renderStates.blendMode = cacheBlendMode;
+      target->draw(cacheSprite, renderStates);
+    } else {
+      renderComponents(target, renderStates);
+    }
+    clearDirty(Dirty::Visual);
+  }
+
+  void Menu::batch(RenderBatch& batch) {
+    sortComponents();
+    if (isCached() && updateCache()) {
+      sf::Sprite sprite = cacheSprite;
+      sprite.move(getPosition());
+      batch.addSprite(sprite, Color::White, cacheBlendMode);
+    } else if (getPosition() == Vec2f()) {
+      batchComponents(batch);
+    } else {
+      // Batched geometry has no transform of its own so an offset Menu has
+      // to be rendered with one. 
+      batch.addComponent(this);
+      return;
     }
+    clearDirty(Dirty::Visual);
   }
 
-  void Menu::add(Component* component, const std::string& name) {
-    components.push_back({component, name});
-    component->menuOffset = getPosition();
+  Menu::Handle Menu::add(Component* component, const std::string& name) {
+    Handle handle;
+    if (!freeSlots.empty()) {
+      handle.index = freeSlots.back();
+      freeSlots.pop_back();
+    } else {
+      handle.index = static_cast<uint32_t>(slots.size());
+      slots.emplace_back();
+    }
+    slots[handle.index].ptr = component;
+    handle.generation = slots[handle.index].generation;
+
+    if (!name.empty()) {
+      // The first Component added with a name keeps it. The others are 
+      // linked after it in the order they were added. 
+      Slot& slot = slots[handle.index];
+      auto it = nameIndex.find(std::string_view(name));
+      if (it == nameIndex.end()) {
+        const std::string& interned = *internedNames.insert(name).first;
+        nameIndex.emplace(std::string_view(interned), handle.index);
+        slot.previousNamed = slot.nextNamed = handle.index;
+      } else {
+        uint32_t first = it->second;
+        uint32_t last = slots[first].previousNamed;
+        slot.previousNamed = last;
+        slot.nextNamed = first;
+        slots[last].nextNamed = handle.index;
+        slots[first].previousNamed = handle.index;
+      }
+    }
+
+    ComponentContainer container;
+    container.ptr = component;
+    container.name = name;
+    container.handle = handle;
+    container.sequence = nextSequence++;
+    components.push_back(std::move(container));
+    component->drawIndex = components.size() - 1;
+    attach(component);
+    if (components.size() > 1 && getOrderKey(component) < getOrderKey(components[components.size() - 2].ptr)) {
+      reorder(component);
+    }
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
+    return handle;
   }
 
-  void Menu::add(Component* component) {
-    add(component, "");
+  Menu::Handle Menu::add(Component* component) {
+    return add(component, "");
   }
 
   void Menu::remove(Component* component) {
-    components.erase(
-      std::remove_if(components.begin(), components.end(),
-        [component](const ComponentContainer& container) {
-          return container.ptr == component;
-        }),
-      components.end()
-    );
+    // drawIndex only says where the Component is in its own Menu. 
+    size_t index = component->drawIndex;
+    if (index < components.size() && components[index].ptr == component) {
+      removeAt(index);
+    }
   }
 
   void Menu::remove(const std::string& name) {
-    components.erase(
-      std::remove_if(components.begin(), components.end(),
-        [&name](const ComponentContainer& container) {
-          return container.name == name;
-        }),
-      components.end()
-    );
+    auto it = nameIndex.find(std::string_view(name));
+    if (it == nameIndex.end()) return;
+    removeAt(slots[it->second].ptr->drawIndex);
+  }
+
+  void Menu::remove(Handle handle) {
+    if (!isValid(handle)) return;
+    removeAt(slots[handle.index].ptr->drawIndex);
+  }
+
+  void Menu::setCached(bool cached) {
+    if (cached == isCached()) return;
+    if (cached) {
+      cacheTexture = std::make_unique<sf::RenderTexture>();
+    } else {
+      cacheTexture.reset();
+    }
+    cacheValid = false;
+  }
+
+  bool Menu::isCached() const {
+    return cacheTexture != nullptr;
+  }
+
+  void Menu::invalidateCache() {
+    cacheValid = false;
+  }
+
+  void Menu::setPartialRedraw(bool enabled) {
+    if (enabled == isPartialRedraw()) return;
+    if (enabled) {
+      backbuffer = std::make_unique<sf::RenderTexture>();
+    } else {
+      backbuffer.reset();
+    }
+    pendingDamage.clear();
+    damage.clear();
+  }
+
+  bool Menu::isPartialRedraw() const {
+    return backbuffer != nullptr;
+  }
+
+  void Menu::addDamage(sf::FloatRect area) {
+    pendingDamage.push_back(area);
+  }
+
+  const vector<sf::FloatRect>& Menu::getDamage() const {
+    return damage;
   }
 
   void Menu::setPosition(Vec2f position) {
     hitbox.setPosition(position);
-    updateInternalComponents();
+    markDirty(Dirty::Transform);
   }
 
   void Menu::setPosition(float xpos, float ypos) {
@@ -76,8 +306,8 @@ namespace gs {
   }
 
   void Menu::move(Vec2f offset) {
-    hitbox.setPosition(hitbox.getPosition() + offset);
-    updateInternalComponents();
+    hitbox.move(offset);
+    markDirty(Dirty::Transform);
   }
 
   void Menu::move(float offsetx, float offsety) {
@@ -85,7 +315,7 @@ namespace gs {
   }
 
   void Menu::applyStyle(const Style& style) {
-    this->style = style;
+    Component::applyStyle(style);
     for (auto& component : components) {
       component.ptr->applyStyle(style);
     }
@@ -119,6 +349,26 @@ namespace gs {
     return locked;
   }
 
+  sf::Transform Menu::getLocalTransform() const {
+    return sf::Transform().translate(getPosition());
+  }
+
+  bool Menu::hasChanged() const {
+    if (Component::hasChanged()) return true;
+    for (const auto& component : components) {
+      if (component.ptr->hasChanged()) return true;
+    }
+    return false;
+  }
+
+  size_t Menu::getDrawCallCount() const {
+    return renderBatch.getDrawCallCount();
+  }
+
+  size_t Menu::getFallbackCount() const {
+    return renderBatch.getFallbackCount();
+  }
+
   Component* Menu::operator[](size_t index) {
     if (index < components.size()) {
       return components[index].ptr;
@@ -127,11 +377,31 @@ namespace gs {
   }
 
   Component* Menu::operator[](const std::string& name) {
-    auto it = std::find_if(components.begin(), components.end(),
-      [&name](const ComponentContainer& container) {
-        return container.name == name;
-      });
-    return (it != components.end()) ? it->ptr : nullptr;
+    return find(name);
+  }
+
+  Component* Menu::find(std::string_view name) const {
+    auto it = nameIndex.find(name);
+    return (it != nameIndex.end()) ? slots[it->second].ptr : nullptr;
+  }
+
+  Component* Menu::get(Handle handle) const {
+    return isValid(handle) ? slots[handle.index].ptr : nullptr;
+  }
+
+  Menu::Handle Menu::getHandle(std::string_view name) const {
+    Handle handle;
+    auto it = nameIndex.find(name);
+    if (it != nameIndex.end()) {
+      handle.index = it->second;
+      handle.generation = slots[it->second].generation;
+    }
+    return handle;
+  }
+
+  bool Menu::isValid(Handle handle) const {
+    return handle.index < slots.size() && slots[handle.index].ptr != nullptr &&
+      slots[handle.index].generation == handle.generation;
   }
 
   void Menu::generateHitbox() {
@@ -148,10 +418,438 @@ namespace gs {
     hitbox.setSize(max - min);
   }
 
-  void Menu::updateInternalComponents() {
+  void Menu::renderComponents(sf::RenderTarget* target, sf::RenderStates renderStates) {
+    bool batched = renderMethod == RenderMethod::Batched;
+    sf::FloatRect visible = getVisibleArea(target, renderStates);
+    if (batched) {
+      renderBatch.clear();
+    }
+    for (auto& component : components) {
+      // Culled Components still count as drawn since they look the same. 
+      if (!culling || getDrawBounds(component.ptr).intersects(visible)) {
+        if (batched) {
+          component.ptr->batch(renderBatch);
+        } else {
+          component.ptr->render(target, renderStates);
+        }
+      }
+      component.ptr->clearDirty(Dirty::Visual);
+    }
+    if (batched) {
+      renderBatch.draw(target, renderStates);
+    }
+  }
+
+  void Menu::batchComponents(RenderBatch& batch) {
     for (auto& component : components) {
-      component.ptr->menuOffset = getPosition();
+      component.ptr->batch(batch);
+      component.ptr->clearDirty(Dirty::Visual);
+    }
+  }
+
+  bool Menu::updateCache() {
+    // The cache is in the space of the Menu so moving the Menu alone doesn't
+    // make it stale. 
+    bool stale = !cacheValid || isDirty(Dirty::Geometry | Dirty::Style);
+    for (size_t i = 0; !stale && i < components.size(); ++i) {
+      stale = components[i].ptr->hasChanged();
+    }
+    if (!stale) return true;
+    if (components.empty()) return false;
+
+    // Area covered by the Components snapped to whole pixels so texels line
+    // up with the target. 
+    sf::FloatRect bounds = getContentBounds();
+    Vec2f min(std::floor(bounds.left), std::floor(bounds.top));
+    Vec2f max(std::ceil(bounds.left + bounds.width), std::ceil(bounds.top + bounds.height));
+    sf::Vector2u size(static_cast<unsigned int>(max.x - min.x), static_cast<unsigned int>(max.y - min.y));
+
+    // The texture only grows so a Component changing size every frame
+    // doesn't recreate it every frame. 
+    sf::Vector2u textureSize = cacheTexture->getSize();
+    if (textureSize.x < size.x || textureSize.y < size.y) {
+      textureSize.x = std::max(textureSize.x, size.x);
+      textureSize.y = std::max(textureSize.y, size.y);
+      if (!cacheTexture->create(textureSize.x, textureSize.y)) {
+        cacheValid = false;
+        return false;
+      }
+    }
+
+    cacheTexture->setView(sf::View(sf::FloatRect(
+      min.x, min.y, static_cast<float>(textureSize.x), static_cast<float>(textureSize.y)
+    )));
+    cacheTexture->clear(Color::Transparent);
+    renderComponents(cacheTexture.get(), sf::RenderStates::Default);
+    cacheTexture->display();
+
+    cacheSprite.setTexture(cacheTexture->getTexture());
+    cacheSprite.setTextureRect(sf::IntRect(0, 0, size.x, size.y));
+    cacheSprite.setPosition(min);
+    cacheValid = true;
+    return true;
+  }
+
+  bool Menu::renderDamage(sf::RenderTarget* target, sf::RenderStates renderStates) {
+    sf::Vector2u size = target->getSize();
+    if (size.x == 0 || size.y == 0) return false;
+
+    Vec2f area(static_cast<float>(size.x), static_cast<float>(size.y));
+    if (backbuffer->getSize() != size) {
+      if (!backbuffer->create(size.x, size.y)) return false;
+      backbufferSprite.setTexture(backbuffer->getTexture(), true);
+      pendingDamage.push_back(sf::FloatRect(0.0f, 0.0f, area.x, area.y));
+    }
+    collectDamage(area, renderStates.transform);
+
+    // Each area is redrawn through a view and viewport covering only that
+    // area so nothing outside of it is touched. 
+    sf::RectangleShape eraser;
+    eraser.setFillColor(Color::Transparent);
+    for (const sf::FloatRect& rect : damage) {
+      sf::View view(rect);
+      view.setViewport(sf::FloatRect(
+        rect.left / area.x, rect.top / area.y, rect.width / area.x, rect.height / area.y
+      ));
+      backbuffer->setView(view);
+
+      eraser.setPosition(rect.left, rect.top);
+      eraser.setSize(Vec2f(rect.width, rect.height));
+      backbuffer->draw(eraser, sf::RenderStates(sf::BlendNone));
+
+      if (renderMethod == RenderMethod::Batched) {
+        renderBatch.clear();
+      }
+      for (auto& component : components) {
+        if (!component.drawnBounds.intersects(rect)) continue;
+        if (renderMethod == RenderMethod::Batched) {
+          component.ptr->batch(renderBatch);
+        } else {
+          component.ptr->render(backbuffer.get(), renderStates);
+        }
+      }
+      if (renderMethod == RenderMethod::Batched) {
+        renderBatch.draw(backbuffer.get(), renderStates);
+      }
+    }
+    if (!damage.empty()) {
+      backbuffer->display();
+    }
+    for (auto& component : components) {
+      component.ptr->clearDirty(Dirty::Visual);
+    }
+
+    // The backbuffer is in pixels so it is drawn with the default view and
+    // without the transform already applied to its content. 
+    sf::RenderStates blitStates(cacheBlendMode);
+    blitStates.shader = renderStates.shader;
+    sf::View view = target->getView();
+    target->setView(target->getDefaultView());
+    target->draw(backbufferSprite, blitStates);
+    target->setView(view);
+    return true;
+  }
+
+  void Menu::collectDamage(Vec2f area, const sf::Transform& transform) {
+    damage.clear();
+    damage.swap(pendingDamage);
+
+    // If the Menu or one of its parents moved everything has to be redrawn.
+    const float* matrix = transform.getMatrix();
+    if (!std::equal(matrix, matrix + 16, drawnTransform.getMatrix())) {
+      drawnTransform = transform;
+      damage.push_back(sf::FloatRect(0.0f, 0.0f, area.x, area.y));
+      for (auto& component : components) {
+        component.drawnBounds = sf::FloatRect();
+      }
+    }
+
+    for (auto& component : components) {
+      // Components that were never drawn to the backbuffer have no bounds. 
+      bool wasDrawn = component.drawnBounds.width > 0.0f && component.drawnBounds.height > 0.0f;
+      if (wasDrawn && !component.ptr->hasChanged()) continue;
+      // Both where the Component was and where it is now need redrawing. 
+      if (wasDrawn) {
+        damage.push_back(component.drawnBounds);
+      }
+      component.drawnBounds = transform.transformRect(getDrawBounds(component.ptr));
+      damage.push_back(component.drawnBounds);
+    }
+
+    size_t kept = 0;
+    for (const sf::FloatRect& rect : damage) {
+      sf::FloatRect snapped = snap(rect, area);
+      if (snapped.width > 0.0f && snapped.height > 0.0f) {
+        damage[kept++] = snapped;
+      }
+    }
+    damage.resize(kept);
+    mergeRects(damage);
+  }
+
+  const sf::FloatRect& Menu::getContentBounds() const {
+    if (!isDirty(Dirty::Hitbox)) return contentBounds;
+    clearDirty(Dirty::Hitbox);
+
+    contentBounds = sf::FloatRect();
+    if (!components.empty()) {
+      contentBounds = getDrawBounds(components.front().ptr);
+      for (const auto& component : components) {
+        contentBounds = util::unite(contentBounds, getDrawBounds(component.ptr));
+      }
+    }
+    return contentBounds;
+  }
+
+  sf::FloatRect Menu::getDrawBounds(const Component* component) {
+    // A Menu's own Hitbox doesn't cover its Components. 
+    if (const Menu* menu = dynamic_cast<const Menu*>(component)) {
+      return menu->getLocalTransform().transformRect(menu->getContentBounds());
+    }
+    sf::FloatRect bounds = component->getHitbox().getBounds();
+    return sf::FloatRect(
+      bounds.left - drawPadding, bounds.top - drawPadding,
+      bounds.width + drawPadding * 2.0f, bounds.height + drawPadding * 2.0f
+    );
+  }
+
+  sf::FloatRect Menu::getVisibleArea(const sf::RenderTarget* target, const sf::RenderStates& renderStates) {
+    // The inverse view transform maps the corners of the screen back to the
+    // world which also covers rotated views. 
+    sf::FloatRect area = target->getView().getInverseTransform().transformRect(
+      sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f)
+    );
+    return renderStates.transform.getInverse().transformRect(area);
+  }
+
+  void Menu::updatePointers() {
+    // Hitboxes of the Components are relative to the Menu. 
+    Vec2f mouse = getWorldTransform().getInverse().transformPoint(input::mousePosition);
+    hitGrid.refresh();
+    hitGrid.query(mouse, pointerCandidates);
+
+    // Only the topmost Component under the mouse is hit. 
+    std::sort(pointerCandidates.begin(), pointerCandidates.end(), [](const Component* a, const Component* b) {
+      return a->drawIndex > b->drawIndex;
+    });
+    pointerHits.clear();
+    for (Component* component : pointerCandidates) {
+      if (component->acceptsPointer() && component->getHitbox().intersects(mouse)) {
+        pointerHits.push_back(component);
+        break;
+      }
+    }
+
+    for (Component* component : hoveredComponents) {
+      if (std::find(pointerHits.begin(), pointerHits.end(), component) == pointerHits.end()) {
+        component->updatePointer(false);
+      }
+    }
+    for (Component* component : pointerHits) {
+      component->updatePointer(true);
+    }
+    hoveredComponents.swap(pointerHits);
+  }
+
+  void Menu::updateParallel(size_t begin, size_t end) {
+    if (end - begin < updateGrainSize) {
+      for (size_t i = begin; i < end; ++i) {
+        components[i].ptr->update();
+      }
+      return;
+    }
+
+    // hitGrid isn't thread safe so changes are collected afterwards. The world
+    // transform of the Menu was already refreshed by updatePointers() so
+    // Components reading it only read. 
+    hitGrid.setDeferred(true);
+    priv::ThreadPool::getDefault().parallelFor(end - begin, updateGrainSize, [this, begin](size_t i) {
+      components[begin + i].ptr->update();
+    });
+    hitGrid.setDeferred(false);
+
+    for (size_t i = begin; i < end; ++i) {
+      Component* component = components[i].ptr;
+      if (component->isDirty(Dirty::Transform | Dirty::Geometry | Dirty::Hitbox)) {
+        hitGrid.invalidate(component);
+      }
+    }
+  }
+
+  void Menu::reorder(Component* component) {
+    if (reorderAll) return;
+    if (std::find(reordered.begin(), reordered.end(), component) != reordered.end()) return;
+    if (reordered.size() == insertionSortLimit) {
+      reordered.clear();
+      reorderAll = true;
+      return;
+    }
+    reordered.push_back(component);
+  }
+
+  void Menu::sortComponents() {
+    if (reorderAll) {
+      radixSort();
+      for (size_t i = 0; i < components.size(); ++i) {
+        components[i].ptr->drawIndex = i;
+      }
+    } else if (!reordered.empty()) {
+      insertionSort();
+    }
+    reordered.clear();
+    reorderAll = false;
+  }
+
+  void Menu::insertionSort() {
+    // Take the reordered Components out, last first so the indices of the 
+    // rest don't change. What is left is still sorted. 
+    std::sort(reordered.begin(), reordered.end(), [](const Component* a, const Component* b) {
+      return a->drawIndex > b->drawIndex;
+    });
+    size_t firstMoved = reordered.back()->drawIndex;
+    vector<ComponentContainer> moving;
+    moving.reserve(reordered.size());
+    for (Component* component : reordered) {
+      moving.push_back(std::move(components[component->drawIndex]));
+      components.erase(components.begin() + component->drawIndex);
+    }
+
+    // Each is put back where a binary search says it belongs. 
+    for (ComponentContainer& container : moving) {
+      auto position = std::upper_bound(components.begin(), components.end(), container,
+        [](const ComponentContainer& a, const ComponentContainer& b) { return isDrawnBefore(a, b); });
+      firstMoved = std::min(firstMoved, static_cast<size_t>(position - components.begin()));
+      components.insert(position, std::move(container));
+    }
+    for (size_t i = firstMoved; i < components.size(); ++i) {
+      components[i].ptr->drawIndex = i;
+    }
+  }
+
+  void Menu::radixSort() {
+    size_t count = components.size();
+    if (count == 0) return;
+    sortKeys.resize(count);
+    sortScratch.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      sortKeys[i] = {getOrderKey(components[i].ptr), components[i].sequence, i};
+    }
+
+    // Least significant byte first: 8 bytes of sequence then 8 bytes of
+    // order. The histograms of every byte are built in one pass. 
+    static const size_t digitCount = 16;
+    size_t histograms[digitCount][256] = {};
+    auto digitOf = [](const SortKey& key, size_t digit) {
+      uint64_t value = digit < 8 ? key.sequence : key.order;
+      return static_cast<size_t>((value >> ((digit % 8) * 8)) & 0xFF);
+    };
+    for (const SortKey& key : sortKeys) {
+      for (size_t digit = 0; digit < digitCount; ++digit) {
+        ++histograms[digit][digitOf(key, digit)];
+      }
+    }
+
+    for (size_t digit = 0; digit < digitCount; ++digit) {
+      size_t* histogram = histograms[digit];
+      // Bytes that are the same for every key don't change the order. 
+      if (histogram[digitOf(sortKeys[0], digit)] == count) continue;
+
+      size_t offset = 0;
+      for (size_t bucket = 0; bucket < 256; ++bucket) {
+        size_t bucketSize = histogram[bucket];
+        histogram[bucket] = offset;
+        offset += bucketSize;
+      }
+      for (const SortKey& key : sortKeys) {
+        sortScratch[histogram[digitOf(key, digit)]++] = key;
+      }
+      sortKeys.swap(sortScratch);
+    }
+
+    sortedComponents.clear();
+    sortedComponents.reserve(count);
+    for (const SortKey& key : sortKeys) {
+      sortedComponents.push_back(std::move(components[key.index]));
+    }
+    components.swap(sortedComponents);
+    sortedComponents.clear();
+  }
+
+  bool Menu::isDrawnBefore(const ComponentContainer& a, const ComponentContainer& b) {
+    uint64_t orderA = getOrderKey(a.ptr), orderB = getOrderKey(b.ptr);
+    return orderA != orderB ? orderA < orderB : a.sequence < b.sequence;
+  }
+
+  uint64_t Menu::getOrderKey(const Component* component) {
+    // Flipping the sign bit makes negative z-indices compare below positive
+    // ones as unsigned numbers. 
+    uint32_t z = static_cast<uint32_t>(component->zIndex) ^ 0x80000000u;
+    return (static_cast<uint64_t>(component->layer) << 32) | z;
+  }
+
+  void Menu::attach(Component* component) {
+    hitGrid.insert(component);
+    component->spatialIndex = &hitGrid;
+    component->setPointerRouted(true);
+    component->parent = this;
+    component->markDirty(Dirty::World);
+  }
+
+  void Menu::detach(Component* component) {
+    hitGrid.remove(component);
+    if (component->spatialIndex == &hitGrid) {
+      component->spatialIndex = nullptr;
+      component->setPointerRouted(false);
+    }
+    if (component->parent == this) {
+      component->parent = nullptr;
+      component->markDirty(Dirty::World);
+    }
+    hoveredComponents.erase(
+      std::remove(hoveredComponents.begin(), hoveredComponents.end(), component),
+      hoveredComponents.end()
+    );
+  }
+
+  void Menu::release(const ComponentContainer& container) {
+    detach(container.ptr);
+    if (isPartialRedraw() && container.drawnBounds.width > 0.0f) {
+      pendingDamage.push_back(container.drawnBounds);
+    }
+
+    uint32_t index = container.handle.index;
+    Slot& slot = slots[index];
+    slot.ptr = nullptr;
+    ++slot.generation;
+    freeSlots.push_back(index);
+
+    if (container.name.empty()) return;
+    auto it = nameIndex.find(std::string_view(container.name));
+    if (slot.nextNamed == index) {
+      nameIndex.erase(it);
+      internedNames.erase(container.name);
+      return;
+    }
+    // Hand the name over to the next Component that shares it. 
+    slots[slot.previousNamed].nextNamed = slot.nextNamed;
+    slots[slot.nextNamed].previousNamed = slot.previousNamed;
+    if (it->second == index) {
+      it->second = slot.nextNamed;
+    }
+  }
+
+  void Menu::removeAt(size_t index) {
+    auto pending = std::find(reordered.begin(), reordered.end(), components[index].ptr);
+    if (pending != reordered.end()) {
+      reordered.erase(pending);
+    }
+    ComponentContainer removed = std::move(components[index]);
+    components.erase(components.begin() + index);
+    for (size_t i = index; i < components.size(); ++i) {
+      components[i].ptr->drawIndex = i;
     }
+    release(removed);
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
   }
 
   void draw(sf::RenderTarget* target, Menu& menu, sf::RenderStates renderStates) {
@@ -0,0 +1,335 @@
+#include "multiGraph.hpp"
+#include "hitbox.hpp"
+#include <algorithm>
+
+namespace gs {
+
+  #include "util/output.hpp"
+
+  MultiGraph::MultiGraph()
+    : Component(), numOfPoints(20), lowerBound(0.0f), upperBound(0.0f),
+      autoAdjustLower(false), autoAdjustUpper(false),
+      backGroundColor(Color::White), outlineColor(Color::Black),
+      outlineThickness(1.0f), pointThickness(0.0f),
+      lineVertices(sf::Lines), pointVertices(sf::Triangles) {
+    graphTexture.create(100, 100);
+    graphSprite.setTexture(graphTexture.getTexture());
+  }
+
+  MultiGraph::~MultiGraph() = default;
+
+  void MultiGraph::update() {
+    if (isLocked()) return;
+    if (!autoAdjustLower && !autoAdjustUpper) return;
+
+    // Each series already knows its own extremes so the shared bounds only
+    // cost one look per series.
+    bool found = false;
+    float min = 0.0f, max = 0.0f;
+    for (const Series& line : series) {
+      if (line.extrema.empty()) continue;
+      min = found ? std::min(min, line.extrema.getMin()) : line.extrema.getMin();
+      max = found ? std::max(max, line.extrema.getMax()) : line.extrema.getMax();
+      found = true;
+    }
+    if (!found) return;
+    if (autoAdjustLower && lowerBound != min) {
+      lowerBound = min;
+      invalidate(Dirty::Geometry);
+    }
+    if (autoAdjustUpper && upperBound != max) {
+      upperBound = max;
+      invalidate(Dirty::Geometry);
+    }
+  }
+
+  bool MultiGraph::isUpdateThreadSafe() const {
+    return true;
+  }
+
+  void MultiGraph::render(sf::RenderTarget* target, sf::RenderStates renderStates) {
+    updateTexture();
+    graphSprite.render(target, renderStates);
+  }
+
+  void MultiGraph::batch(RenderBatch& batch) {
+    updateTexture();
+    graphSprite.batch(batch);
+  }
+
+  size_t MultiGraph::addSeries(Color color) {
+    Series line;
+    line.points.setCapacity(numOfPoints);
+    line.extrema.setWindow(numOfPoints);
+    line.color = color;
+    series.push_back(std::move(line));
+    invalidate(Dirty::Geometry);
+    return series.size() - 1;
+  }
+
+  void MultiGraph::removeSeries(size_t index) {
+    series.erase(series.begin() + index);
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::graph(size_t index, float value) {
+    series[index].points.push(value);
+    series[index].extrema.push(value);
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::graph(size_t index, const float* values, size_t count) {
+    if (count == 0) return;
+    series[index].points.push(values, count);
+    series[index].extrema.push(values, count);
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::clear() {
+    for (Series& line : series) {
+      line.points.clear();
+      line.extrema.clear();
+    }
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::updateTexture() {
+    // Nothing changed since the last frame so the texture is still right.
+    if (generation == drawnGeneration) return;
+    drawnGeneration = generation;
+
+    if (verticesStale) {
+      generateVertices();
+    }
+
+    graphTexture.clear(backGroundColor);
+    graphTexture.draw(lineVertices);
+    graphTexture.draw(pointVertices);
+    graphTexture.display();
+  }
+
+  void MultiGraph::generateVertices() {
+    verticesStale = false;
+    lineVertices.clear();
+    pointVertices.clear();
+
+    float height = static_cast<float>(graphTexture.getSize().y);
+    float xStep = graphTexture.getSize().x / static_cast<float>(numOfPoints - 1);
+    float yScale = height / (upperBound - lowerBound);
+
+    // Every series goes into the same line list so there is one draw call no
+    // matter how many there are.
+    for (const Series& line : series) {
+      size_t count = line.points.size();
+      if (count == 0) continue;
+      seriesVertices.resize(count);
+      size_t i = 0;
+      for (float point : line.points) {
+        Vec2f position(i * xStep, height - (point - lowerBound) * yScale);
+        seriesVertices[i++] = sf::Vertex(position, line.color);
+      }
+      for (i = 1; i < count; ++i) {
+        lineVertices.append(seriesVertices[i - 1]);
+        lineVertices.append(seriesVertices[i]);
+      }
+      priv::addMarkers(&seriesVertices[0], count, pointThickness, line.color, pointVertices);
+    }
+  }
+
+  void MultiGraph::invalidate(Dirty flags) {
+    verticesStale = true;
+    ++generation;
+    markDirty(flags);
+  }
+
+  void MultiGraph::setPosition(Vec2f position) {
+    graphSprite.setPosition(position);
+    generateHitbox();
+    markDirty(Dirty::Transform);
+  }
+
+  void MultiGraph::setPosition(float xpos, float ypos) {
+    setPosition(Vec2f(xpos, ypos));
+  }
+
+  void MultiGraph::setCenter(Vec2f position) {
+    Vec2f size = getSize();
+    setPosition(position - size / 2.0f);
+  }
+
+  void MultiGraph::setCenter(float xpos, float ypos) {
+    setCenter(Vec2f(xpos, ypos));
+  }
+
+  void MultiGraph::move(Vec2f offset) {
+    graphSprite.move(offset);
+    generateHitbox();
+    markDirty(Dirty::Transform);
+  }
+
+  void MultiGraph::move(float offsetx, float offsety) {
+    move(Vec2f(offsetx, offsety));
+  }
+
+  void MultiGraph::applyStyle(const Style& style) {
+    Component::applyStyle(style);
+    setFillColor(style.fillColor);
+    setOutlineColor(style.outlineColor);
+    setOutlineThickness(style.outlineThickness);
+  }
+
+  void MultiGraph::lock() {
+    Component::lock();
+  }
+
+  void MultiGraph::unlock() {
+    Component::unlock();
+  }
+
+  void MultiGraph::setSize(Vec2f size) {
+    graphTexture.create(static_cast<unsigned int>(size.x), static_cast<unsigned int>(size.y));
+    graphSprite.setTexture(graphTexture.getTexture(), true);
+    generateHitbox();
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::setSize(float width, float height) {
+    setSize(Vec2f(width, height));
+  }
+
+  void MultiGraph::setLowerBound(float height) {
+    lowerBound = height;
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::setUpperBound(float height) {
+    upperBound = height;
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::setLowerBoundAutoAdjust(bool enabled) {
+    autoAdjustLower = enabled;
+  }
+
+  void MultiGraph::setUpperBoundAutoAdjust(bool enabled) {
+    autoAdjustUpper = enabled;
+  }
+
+  void MultiGraph::setPointCount(size_t numOfPoints) {
+    this->numOfPoints = numOfPoints;
+    for (Series& line : series) {
+      line.points.setCapacity(numOfPoints);
+      line.extrema.setWindow(numOfPoints);
+    }
+    invalidate(Dirty::Geometry);
+  }
+
+  void MultiGraph::setSeriesColor(size_t index, Color color) {
+    series[index].color = color;
+    invalidate(Dirty::Style);
+  }
+
+  void MultiGraph::setFillColor(Color color) {
+    backGroundColor = color;
+    invalidate(Dirty::Style);
+  }
+
+  void MultiGraph::setOutlineThickness(float thickness) {
+    outlineThickness = thickness;
+    graphSprite.setOutlineThickness(thickness);
+    markDirty(Dirty::Style);
+  }
+
+  void MultiGraph::setOutlineColor(Color color) {
+    outlineColor = color;
+    graphSprite.setOutlineColor(color);
+    markDirty(Dirty::Style);
+  }
+
+  void MultiGraph::setPointThickness(float thickness) {
+    pointThickness = thickness;
+    invalidate(Dirty::Style);
+  }
+
+  Vec2f MultiGraph::getPosition() const {
+    return graphSprite.getPosition();
+  }
+
+  Vec2f MultiGraph::getCenter() const {
+    return getPosition() + getSize() / 2.0f;
+  }
+
+  const Hitbox& MultiGraph::getHitbox() const {
+    return Component::getHitbox();
+  }
+
+  bool MultiGraph::isLocked() const {
+    return Component::isLocked();
+  }
+
+  Vec2f MultiGraph::getSize() const {
+    return Vec2f(graphTexture.getSize().x, graphTexture.getSize().y);
+  }
+
+  float MultiGraph::getLowerBound() const {
+    return lowerBound;
+  }
+
+  float MultiGraph::getUpperBound() const {
+    return upperBound;
+  }
+
+  bool MultiGraph::getLowerBoundAutoAdjust() const {
+    return autoAdjustLower;
+  }
+
+  bool MultiGraph::getUpperBoundAutoAdjust() const {
+    return autoAdjustUpper;
+  }
+
+  size_t MultiGraph::getPointCount() const {
+    return numOfPoints;
+  }
+
+  size_t MultiGraph::getSeriesCount() const {
+    return series.size();
+  }
+
+  Color MultiGraph::getSeriesColor(size_t index) const {
+    return series[index].color;
+  }
+
+  Color MultiGraph::getFillColor() const {
+    return backGroundColor;
+  }
+
+  float MultiGraph::getOutlineThickness() const {
+    return outlineThickness;
+  }
+
+  Color MultiGraph::getOutlineColor() const {
+    return outlineColor;
+  }
+
+  float MultiGraph::getPointThickness() const {
+    return pointThickness;
+  }
+
+  void MultiGraph::generateHitbox() {
+    Hitbox newHitbox(Hitbox::Shape::Rectangle);
+    newHitbox.setPosition(getPosition());
+    newHitbox.setSize(getSize());
+    hitbox = newHitbox;
+  }
+
+  void draw(sf::RenderTarget* target, MultiGraph& graph, sf::RenderStates renderStates) {
+    graph.render(target, renderStates);
+  }
+
+  std::ostream& operator<<(std::ostream& os, const MultiGraph& graph) {
+    return os << "MultiGraph(pos: " << graph.getPosition()
+              << ", size: " << graph.getSize()
+              << ", series: " << graph.getSeriesCount() << ")";
+  }
+
+}
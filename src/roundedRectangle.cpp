@@ -73,9 +73,30 @@ namespace gs {
       target->draw(internalShape, renderStates);
   }
 
+  void RoundedRectangle::batch(RenderBatch& batch) {
+      size_t pointCount = internalShape.getPointCount();
+      if (internalShape.getOutlineThickness() != 0.0f || pointCount < 3) {
+          // Outlines are left to sf::Shape.
+          batch.addComponent(this);
+          return;
+      }
+
+      const sf::Transform& transform = internalShape.getTransform();
+      Color color = internalShape.getFillColor();
+      sf::Vertex center(transform.transformPoint(getSize() / 2.0f), color);
+
+      sf::Vertex* vertices = batch.addTriangles(pointCount * 3, internalShape.getGlobalBounds());
+      for (size_t i = 0; i < pointCount; ++i) {
+          *vertices++ = center;
+          *vertices++ = sf::Vertex(transform.transformPoint(internalShape.getPoint(i)), color);
+          *vertices++ = sf::Vertex(transform.transformPoint(internalShape.getPoint((i + 1) % pointCount)), color);
+      }
+  }
+
   void RoundedRectangle::setPosition(Vec2f position) {
       internalShape.setPosition(position);
       generateHitbox();
+      markDirty(Dirty::Transform);
   }
 
   void RoundedRectangle::setPosition(float xpos, float ypos) {
@@ -94,6 +115,7 @@ namespace gs {
   void RoundedRectangle::move(Vec2f offset) {
       internalShape.move(offset);
       generateHitbox();
+      markDirty(Dirty::Transform);
   }
 
   void RoundedRectangle::move(float offsetx, float offsety) {
@@ -101,7 +123,7 @@ namespace gs {
   }
 
   void RoundedRectangle::applyStyle(const Style& style) {
-    this->style = style;
+    Component::applyStyle(style);
   }
 
   void RoundedRectangle::lock() {
@@ -115,6 +137,7 @@ namespace gs {
   void RoundedRectangle::setSize(Vec2f size) {
       internalShape.setSize(size);
       generateHitbox();
+      markDirty(Dirty::Geometry);
   }
 
   void RoundedRectangle::setSize(float width, float height) {
@@ -124,23 +147,28 @@ namespace gs {
   void RoundedRectangle::setCornerRadius(float radius) {
       internalShape.setCornersRadius(radius);
       generateHitbox();
+      markDirty(Dirty::Geometry);
   }
 
   void RoundedRectangle::setCornerPointCount(unsigned int count) {
       internalShape.setCornerPointCount(count);
+      markDirty(Dirty::Geometry);
   }
 
   void RoundedRectangle::setFillColor(Color color) {
       internalShape.setFillColor(color);
+      markDirty(Dirty::Style);
   }
 
   void RoundedRectangle::setOutlineThickness(float thickness) {
       internalShape.setOutlineThickness(thickness);
       generateHitbox();
+      markDirty(Dirty::Style);
   }
 
   void RoundedRectangle::setOutlineColor(Color color) {
       internalShape.setOutlineColor(color);
+      markDirty(Dirty::Style);
   }
 
   Vec2f RoundedRectangle::getPosition() const {
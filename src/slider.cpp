@@ -1,6 +1,7 @@
 #include "slider.hpp"
 #include "hitbox.hpp"
 #include "input/mouse.hpp"
+#include <cmath>
 
 namespace gs {
 
@@ -14,13 +15,25 @@ namespace gs {
     offOutlineColor = sf::Color::Black;
     onOutlineThickness = 1.0f;
     offOutlineThickness = 1.0f;
+    // The Slider decides when its Button is under the mouse. 
+    button.setPointerRouted(true);
   }
 
   Slider::~Slider() {}
 
   void Slider::update() {
     if (!isLocked()) {
+      // The Slider is positioned relative to its Menu. 
+      Vec2f mousePos = getWorldTransform().getInverse().transformPoint(input::mousePosition);
+      if (!pointerRouted) {
+        updatePointer(getHitbox().intersects(mousePos) || button.getHitbox().intersects(mousePos));
+      }
       button.update();
+      // Changes to the internal Button are reported by the Slider. 
+      if (button.hasChanged()) {
+        markDirty(Dirty::Style);
+        button.clearDirty(Dirty::Visual);
+      }
       
       if (button.isSelected) {
         isSelected = true;
@@ -31,7 +44,6 @@ namespace gs {
       if (button.isClickedOn) {
         isClickedOn = true;
         if (!disableMovement) {
-          Vec2f mousePos = input::mousePosition;
           Vec2f sliderPos = getPosition();
           Vec2f sliderSize = getSize();
 
@@ -49,8 +61,17 @@ namespace gs {
         isClickedOn = false;
       }
 
-      // Smooth transition for renderPercentage
-      renderPercentage += (percentage - renderPercentage) * 0.1f;
+      // Smooth transition for renderPercentage. Snaps once close enough so 
+      // the Slider stops changing. 
+      float difference = percentage - renderPercentage;
+      if (difference != 0.0f) {
+        if (std::abs(difference) < 0.01f) {
+          renderPercentage = percentage;
+        } else {
+          renderPercentage += difference * 0.1f;
+        }
+        markDirty(Dirty::Geometry);
+      }
     }
   }
 
@@ -80,6 +101,20 @@ namespace gs {
     button.render(target, renderStates);
   }
 
+  void Slider::batch(RenderBatch& batch) {
+    batch.addRectangle(getPosition(), getSize(), offColor, offOutlineThickness, offOutlineColor);
+
+    Vec2f filledSize = getSize();
+    if (direction == Direction::Horizontal) {
+      filledSize.x *= renderPercentage / 100.0f;
+    } else {
+      filledSize.y *= renderPercentage / 100.0f;
+    }
+    batch.addRectangle(getPosition(), filledSize, onColor, onOutlineThickness, onOutlineColor);
+
+    button.batch(batch);
+  }
+
   void Slider::setPosition(Vec2f position) {
     Component::setPosition(position);
     setButtonPosition(calculateButtonPosition());
@@ -108,7 +143,7 @@ namespace gs {
 
   void Slider::applyStyle(const Style& style) {
     button.applyStyle(style);
-    this->style = style;
+    Component::applyStyle(style);
   }
 
   void Slider::lock() {
@@ -125,6 +160,7 @@ namespace gs {
     button.setSize(size);
     generateHitbox();
     setButtonPosition(calculateButtonPosition());
+    markDirty(Dirty::Geometry);
   }
 
   void Slider::setSize(float width, float height) {
@@ -133,26 +169,32 @@ namespace gs {
 
   void Slider::setOnColor(Color color) {
     onColor = color;
+    markDirty(Dirty::Style);
   }
 
   void Slider::setOffColor(Color color) {
     offColor = color;
+    markDirty(Dirty::Style);
   }
 
   void Slider::setOnOutlineColor(Color color) {
     onOutlineColor = color;
+    markDirty(Dirty::Style);
   }
 
   void Slider::setOffOutlineColor(Color color) {
     offOutlineColor = color;
+    markDirty(Dirty::Style);
   }
 
   void Slider::setOnOutlineThickness(float thickness) {
     onOutlineThickness = thickness;
+    markDirty(Dirty::Style);
   }
 
   void Slider::setOffOutlineThickness(float thickness) {
     offOutlineThickness = thickness;
+    markDirty(Dirty::Style);
   }
 
   void Slider::setClampedToEdge(bool clamped) {
@@ -189,6 +231,19 @@ namespace gs {
     return Component::isLocked();
   }
 
+  bool Slider::acceptsPointer() const {
+    return !isLocked();
+  }
+
+  bool Slider::isUpdateThreadSafe() const {
+    return true;
+  }
+
+  void Slider::updatePointer(bool hovered) {
+    Vec2f mousePos = getWorldTransform().getInverse().transformPoint(input::mousePosition);
+    button.updatePointer(hovered && button.getHitbox().intersects(mousePos));
+  }
+
   Vec2f Slider::getSize() const {
     return button.getSize();
   }
@@ -238,6 +293,7 @@ namespace gs {
 
   void Slider::setButtonPosition(Vec2f position) {
     button.setPosition(position);
+    markDirty(Dirty::Geometry);
   }
 
   void Slider::setButtonPosition(float xpos, float ypos) {
@@ -0,0 +1,146 @@
+#include "spatialGrid.hpp"
+#include "component.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace gs {
+  namespace priv {
+
+    namespace {
+      // Components covering more cells than this are kept in a single list.
+      const int maxCellsPerComponent = 64;
+
+      void eraseFrom(vector<Component*>& list, Component* component) {
+        auto it = std::find(list.begin(), list.end(), component);
+        if (it != list.end()) {
+          *it = list.back();
+          list.pop_back();
+        }
+      }
+    }
+
+    SpatialGrid::SpatialGrid(float cellSize) : cellSize(cellSize) {}
+
+    SpatialGrid::~SpatialGrid() = default;
+
+    void SpatialGrid::setOwner(Component* owner) {
+      this->owner = owner;
+    }
+
+    void SpatialGrid::setDeferred(bool deferred) {
+      this->deferred = deferred;
+    }
+
+    void SpatialGrid::insert(Component* component) {
+      entries.emplace(component, Entry());
+      invalidate(component);
+    }
+
+    void SpatialGrid::remove(Component* component) {
+      auto it = entries.find(component);
+      if (it == entries.end()) return;
+      unlink(component, it->second);
+      if (it->second.pending) {
+        eraseFrom(pending, component);
+      }
+      entries.erase(it);
+    }
+
+    void SpatialGrid::invalidate(Component* component) {
+      if (deferred) return;
+      auto it = entries.find(component);
+      if (it == entries.end()) return;
+      // The owner is notified even if the Component is already queued since
+      // it may have used the Hitbox since. Once flagged the owner has already
+      // told its own parents. 
+      if (owner != nullptr && !owner->isDirty(Component::Dirty::Hitbox)) {
+        owner->markDirty(Component::Dirty::Hitbox);
+      }
+      if (it->second.pending) return;
+      it->second.pending = true;
+      pending.push_back(component);
+    }
+
+    void SpatialGrid::refresh() {
+      for (Component* component : pending) {
+        Entry& entry = entries[component];
+        entry.pending = false;
+
+        sf::FloatRect bounds = component->getHitbox().getBounds();
+        int minx = static_cast<int>(std::floor(bounds.left / cellSize));
+        int miny = static_cast<int>(std::floor(bounds.top / cellSize));
+        int maxx = static_cast<int>(std::floor((bounds.left + bounds.width) / cellSize));
+        int maxy = static_cast<int>(std::floor((bounds.top + bounds.height) / cellSize));
+        bool isOversized = (maxx - minx + 1) * (maxy - miny + 1) > maxCellsPerComponent;
+
+        if (isOversized == entry.oversized && (isOversized ||
+          (minx == entry.minx && miny == entry.miny && maxx == entry.maxx && maxy == entry.maxy))) {
+          continue;
+        }
+
+        unlink(component, entry);
+        entry.oversized = isOversized;
+        entry.minx = minx;
+        entry.miny = miny;
+        entry.maxx = maxx;
+        entry.maxy = maxy;
+
+        if (isOversized) {
+          oversized.push_back(component);
+          continue;
+        }
+        for (int y = miny; y <= maxy; ++y) {
+          for (int x = minx; x <= maxx; ++x) {
+            cells[cellKey(x, y)].push_back(component);
+          }
+        }
+      }
+      pending.clear();
+    }
+
+    void SpatialGrid::clear() {
+      entries.clear();
+      cells.clear();
+      oversized.clear();
+      pending.clear();
+    }
+
+    void SpatialGrid::query(Vec2f point, vector<Component*>& results) const {
+      results.clear();
+      int x = static_cast<int>(std::floor(point.x / cellSize));
+      int y = static_cast<int>(std::floor(point.y / cellSize));
+      auto it = cells.find(cellKey(x, y));
+      if (it != cells.end()) {
+        results.insert(results.end(), it->second.begin(), it->second.end());
+      }
+      results.insert(results.end(), oversized.begin(), oversized.end());
+    }
+
+    size_t SpatialGrid::size() const {
+      return entries.size();
+    }
+
+    void SpatialGrid::unlink(Component* component, Entry& entry) {
+      if (entry.oversized) {
+        eraseFrom(oversized, component);
+        entry.oversized = false;
+      } else {
+        for (int y = entry.miny; y <= entry.maxy; ++y) {
+          for (int x = entry.minx; x <= entry.maxx; ++x) {
+            auto it = cells.find(cellKey(x, y));
+            if (it == cells.end()) continue;
+            eraseFrom(it->second, component);
+            if (it->second.empty()) cells.erase(it);
+          }
+        }
+      }
+      entry.minx = entry.miny = 0;
+      entry.maxx = entry.maxy = -1;
+    }
+
+    long long SpatialGrid::cellKey(int x, int y) {
+      return (static_cast<long long>(x) << 32) ^ static_cast<unsigned int>(y);
+    }
+
+  }
+}
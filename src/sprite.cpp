@@ -25,6 +25,16 @@ void Sprite::render(sf::RenderTarget* target, sf::RenderStates renderStates) {
     target->draw(sprite, renderStates);
 }
 
+void Sprite::batch(RenderBatch& batch) {
+    if (outlineThickness > 0) {
+        sf::Sprite outlineSprite = sprite;
+        outlineSprite.setScale(sprite.getScale().x + outlineThickness / sprite.getTextureRect().width,
+                               sprite.getScale().y + outlineThickness / sprite.getTextureRect().height);
+        batch.addSprite(outlineSprite, outlineColor);
+    }
+    batch.addSprite(sprite, sprite.getColor());
+}
+
 void Sprite::setPosition(Vec2f position) {
     Component::setPosition(position);
     sprite.setPosition(position);
@@ -71,6 +81,7 @@ void Sprite::unlock() {
 void Sprite::setScale(Vec2f scalar) {
     sprite.setScale(scalar);
     generateHitbox();
+    markDirty(Dirty::Geometry);
 }
 
 void Sprite::setScale(float scalex, float scaley) {
@@ -80,33 +91,40 @@ void Sprite::setScale(float scalex, float scaley) {
 void Sprite::setRotation(float angle) {
     sprite.setRotation(angle);
     generateHitbox();
+    markDirty(Dirty::Geometry);
 }
 
 void Sprite::rotate(float angle) {
     sprite.rotate(angle);
     generateHitbox();
+    markDirty(Dirty::Geometry);
 }
 
 void Sprite::setTexture(const sf::Texture& texture, bool resetRect) {
     sprite.setTexture(texture, resetRect);
     generateHitbox();
+    markDirty(Dirty::Geometry);
 }
 
 void Sprite::setTextureRect(const sf::IntRect& bounds) {
     sprite.setTextureRect(bounds);
     generateHitbox();
+    markDirty(Dirty::Geometry);
 }
 
 void Sprite::setColor(Color color) {
     sprite.setColor(color);
+    markDirty(Dirty::Style);
 }
 
 void Sprite::setOutlineThickness(float thickness) {
     outlineThickness = thickness;
+    markDirty(Dirty::Style);
 }
 
 void Sprite::setOutlineColor(Color color) {
     outlineColor = color;
+    markDirty(Dirty::Style);
 }
 
 Vec2f Sprite::getScale() const {
@@ -1,10 +1,358 @@
 #include "text.hpp"
+#include "util/lruCache.hpp"
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <mutex>
 
 namespace gs {
   #include "util/output.hpp"
 
-  Text::Text() : shadow(false), shadowOffset(1.0f, 1.0f), shadowColor(0, 0, 0, 128) {
+  namespace {
+    /// Everything about a sf::Text that changes where its glyphs go and 
+    /// what color they are. 
+    struct LayoutKey {
+      const sf::Font* font;
+      unsigned int size;
+      sf::Uint32 style;
+      float outlineThickness, letterSpacing, lineSpacing;
+      sf::Color fillColor, outlineColor;
+      vector<sf::Uint32> string;
+      size_t hash;
+
+      bool operator==(const LayoutKey& other) const {
+        return hash == other.hash && font == other.font && size == other.size &&
+          style == other.style && outlineThickness == other.outlineThickness &&
+          letterSpacing == other.letterSpacing && lineSpacing == other.lineSpacing &&
+          fillColor == other.fillColor && outlineColor == other.outlineColor &&
+          string == other.string;
+      }
+    };
+
+    struct LayoutKeyHash {
+      size_t operator()(const LayoutKey& key) const {
+        return key.hash;
+      }
+    };
+
+    LayoutKey makeLayoutKey(const sf::Text& text) {
+      // Without an outline its color isn't used so it is left out to share 
+      // more layouts. 
+      sf::Color outlineColor = text.getOutlineThickness() != 0.0f ? text.getOutlineColor() : sf::Color::Transparent;
+      LayoutKey key = { text.getFont(), text.getCharacterSize(), text.getStyle(),
+        text.getOutlineThickness(), text.getLetterSpacing(), text.getLineSpacing(),
+        text.getFillColor(), outlineColor, {}, 0 };
+      const sf::String& string = text.getString();
+      key.string.resize(string.getSize());
+      // FNV-1a over the characters. The other fields are mixed in after. 
+      uint64_t hash = 14695981039346656037ull;
+      for (size_t i = 0; i < key.string.size(); ++i) {
+        key.string[i] = string[i];
+        hash = (hash ^ key.string[i]) * 1099511628211ull;
+      }
+      std::hash<float> hashFloat;
+      hash ^= std::hash<const void*>()(key.font) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+      hash ^= (uint64_t(key.size) << 32 | key.style) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+      hash ^= hashFloat(key.outlineThickness) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+      hash ^= hashFloat(key.letterSpacing) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+      hash ^= hashFloat(key.lineSpacing) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+      hash ^= (uint64_t(key.fillColor.toInteger()) << 32 | key.outlineColor.toInteger()) +
+        0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+      key.hash = static_cast<size_t>(hash);
+      return key;
+    }
+
+    /// Layouts shared by every Text. Guarded by layoutMutex since Texts can 
+    /// be measured from parallel updates. 
+    std::mutex layoutMutex;
+    util::LruCache<LayoutKey, std::shared_ptr<const priv::TextLayout>, LayoutKeyHash> layoutCache(256);
+
+    /// Font metrics shared by every character of a layout. 
+    struct LayoutStyle {
+      const sf::Font* font;
+      unsigned int size;
+      bool isBold, isUnderlined, isStrikeThrough;
+      float outlineThickness, italicShear;
+      float whitespaceWidth, letterSpacing, lineSpacing;
+      float underlineOffset, underlineThickness, strikeThroughOffset;
+    };
+
+    LayoutStyle makeLayoutStyle(const sf::Text& text) {
+      LayoutStyle style = {};
+      style.font = text.getFont();
+      if (style.font == nullptr) return style;
+      style.size = text.getCharacterSize();
+      style.isBold = text.getStyle() & sf::Text::Bold;
+      style.isUnderlined = text.getStyle() & sf::Text::Underlined;
+      style.isStrikeThrough = text.getStyle() & sf::Text::StrikeThrough;
+      style.outlineThickness = text.getOutlineThickness();
+      style.italicShear = (text.getStyle() & sf::Text::Italic) ? 0.209f : 0.0f;
+      style.whitespaceWidth = style.font->getGlyph(L' ', style.size, style.isBold).advance;
+      style.letterSpacing = (style.whitespaceWidth / 3.0f) * (text.getLetterSpacing() - 1.0f);
+      style.whitespaceWidth += style.letterSpacing;
+      style.lineSpacing = style.font->getLineSpacing(style.size) * text.getLineSpacing();
+      style.underlineOffset = style.font->getUnderlinePosition(style.size);
+      style.underlineThickness = style.font->getUnderlineThickness(style.size);
+      sf::FloatRect xBounds = style.font->getGlyph(L'x', style.size, style.isBold).bounds;
+      style.strikeThroughOffset = xBounds.top + xBounds.height / 2.0f;
+      return style;
+    }
+
+    void addQuad(vector<sf::Vertex>& vertices, float left, float top, float right, float bottom,
+      float u1, float v1, float u2, float v2, float shear, sf::Color color) {
+      sf::Vertex topLeft(Vec2f(left - shear * top, top), color, Vec2f(u1, v1));
+      sf::Vertex topRight(Vec2f(right - shear * top, top), color, Vec2f(u2, v1));
+      sf::Vertex bottomLeft(Vec2f(left - shear * bottom, bottom), color, Vec2f(u1, v2));
+      sf::Vertex bottomRight(Vec2f(right - shear * bottom, bottom), color, Vec2f(u2, v2));
+      vertices.insert(vertices.end(), { topLeft, topRight, bottomLeft, bottomLeft, topRight, bottomRight });
+    }
+
+    void addGlyph(vector<sf::Vertex>& vertices, Vec2f position, const sf::Glyph& glyph,
+      float shear, sf::Color color) {
+      const float padding = 1.0f;
+      float left = glyph.bounds.left - padding;
+      float top = glyph.bounds.top - padding;
+      float right = glyph.bounds.left + glyph.bounds.width + padding;
+      float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+      float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+      float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+      float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+      float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+      addQuad(vertices, position.x + left, position.y + top, position.x + right, position.y + bottom,
+        u1, v1, u2, v2, shear, color);
+    }
+
+    /// Adds an underline or strike through. Lines use the white pixel every 
+    /// font page keeps at (1, 1). 
+    void addLine(priv::TextLayout& layout, const LayoutStyle& style, float length, float lineTop,
+      float offset, sf::Color fillColor, sf::Color outlineColor) {
+      float top = std::floor(lineTop + offset - style.underlineThickness / 2.0f + 0.5f);
+      float bottom = top + std::floor(style.underlineThickness + 0.5f);
+      addQuad(layout.vertices, 0.0f, top, length, bottom, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, fillColor);
+      float outline = style.outlineThickness;
+      if (outline != 0.0f) {
+        addQuad(layout.outlineVertices, -outline, top - outline, length + outline, bottom + outline,
+          1.0f, 1.0f, 1.0f, 1.0f, 0.0f, outlineColor);
+      }
+    }
+
+    /// Rebuilds what depends on every line: the underlines, strike throughs 
+    /// and bounds. Costs one step per line. 
+    void finishLayout(priv::TextLayout& layout, const LayoutStyle& style, size_t length,
+      sf::Color fillColor, sf::Color outlineColor) {
+      layout.vertices.resize(layout.glyphQuadCount * 6);
+      layout.outlineVertices.resize(style.outlineThickness != 0.0f ? layout.glyphQuadCount * 6 : 0);
+      if (length == 0) {
+        layout.localBounds = sf::FloatRect();
+        layout.quadBounds = sf::FloatRect();
+        return;
+      }
+
+      // Same starting bounds as sf::Text. 
+      float minX = static_cast<float>(style.size), minY = static_cast<float>(style.size);
+      float maxX = 0.0f, maxY = 0.0f;
+      for (size_t line = 0; line < layout.lines.size(); ++line) {
+        size_t first = layout.lines[line].firstCharacter;
+        size_t end = line + 1 < layout.lines.size() ? layout.lines[line + 1].firstCharacter : length;
+        if (end == first) continue;
+        const priv::TextLayout::Character& last = layout.characters[end - 1];
+        float y = style.size + line * style.lineSpacing;
+        minX = std::min(minX, last.minX);
+        maxX = std::max(maxX, last.maxX);
+        minY = std::min(minY, y + last.minY);
+        maxY = std::max(maxY, y + last.maxY);
+        if (last.x > 0.0f) {
+          if (style.isUnderlined) {
+            addLine(layout, style, last.x, y, style.underlineOffset, fillColor, outlineColor);
+          }
+          if (style.isStrikeThrough) {
+            addLine(layout, style, last.x, y, style.strikeThroughOffset, fillColor, outlineColor);
+          }
+        }
+      }
+      if (style.outlineThickness != 0.0f) {
+        float outline = std::abs(std::ceil(style.outlineThickness));
+        minX -= outline;
+        maxX += outline;
+        minY -= outline;
+        maxY += outline;
+      }
+      layout.localBounds = sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+
+      // Quads are padded by a pixel around the glyphs. Lines can reach past 
+      // the glyphs so they are added on. 
+      const float padding = 2.0f;
+      Vec2f quadMin(minX - padding, minY - padding), quadMax(maxX + padding, maxY + padding);
+      for (size_t i = layout.glyphQuadCount * 6; i < layout.vertices.size(); ++i) {
+        Vec2f position = layout.vertices[i].position;
+        quadMin = Vec2f(std::min(quadMin.x, position.x), std::min(quadMin.y, position.y));
+        quadMax = Vec2f(std::max(quadMax.x, position.x), std::max(quadMax.y, position.y));
+      }
+      for (size_t i = layout.glyphQuadCount * 6; i < layout.outlineVertices.size(); ++i) {
+        Vec2f position = layout.outlineVertices[i].position;
+        quadMin = Vec2f(std::min(quadMin.x, position.x), std::min(quadMin.y, position.y));
+        quadMax = Vec2f(std::max(quadMax.x, position.x), std::max(quadMax.y, position.y));
+      }
+      layout.quadBounds = sf::FloatRect(quadMin, quadMax - quadMin);
+    }
+  }
+
+  namespace priv {
+    void relayoutText(TextLayout& layout, const sf::Text& text, size_t first, size_t oldEnd,
+      size_t newEnd, sf::Color fillColor, sf::Color outlineColor) {
+      using Character = TextLayout::Character;
+      const sf::String& string = text.getString();
+      size_t length = string.getSize();
+      LayoutStyle style = makeLayoutStyle(text);
+      if (layout.lines.empty() || style.font == nullptr) {
+        layout = TextLayout();
+        layout.lines.push_back({ 0, 0 });
+        if (style.font == nullptr) return;
+        first = 0;
+        oldEnd = 0;
+        newEnd = length;
+      }
+
+      // Characters after the changed ones keep their place once a newline 
+      // starts a fresh line, so only the rest of that line is laid out. 
+      size_t newStop = newEnd;
+      bool terminated = false;
+      while (newStop < length) {
+        if (string[newStop++] == L'\n') {
+          terminated = true;
+          break;
+        }
+      }
+      size_t oldStop = newStop - newEnd + oldEnd;
+
+      // Pick up from the character before the change. 
+      size_t line = std::upper_bound(layout.lines.begin() + 1, layout.lines.end(), first,
+        [](size_t index, const TextLayout::Line& other) { return index < other.firstCharacter; }
+      ) - layout.lines.begin() - 1;
+      size_t lineStart = layout.lines[line].firstCharacter;
+      Character state = { 0.0f, 0, FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX };
+      if (first > lineStart) {
+        state = layout.characters[first - 1];
+      }
+      sf::Uint32 previous = line == 0 ? 0 : L'\n';
+      for (size_t i = first; i > lineStart; --i) {
+        if (string[i - 1] != L'\r') {
+          previous = string[i - 1];
+          break;
+        }
+      }
+      size_t firstQuad = layout.lines[line].firstQuad + state.quadEnd;
+      size_t firstKept = line + 1;
+      while (firstKept < layout.lines.size() &&
+        (!terminated || layout.lines[firstKept].firstCharacter < oldStop)) {
+        ++firstKept;
+      }
+      size_t oldQuadStop = firstKept < layout.lines.size() ?
+        layout.lines[firstKept].firstQuad : layout.glyphQuadCount;
+
+      vector<Character> characters;
+      vector<TextLayout::Line> lines;
+      vector<sf::Vertex> fill, outline;
+      float y = style.size + line * style.lineSpacing;
+      for (size_t i = first; i < newStop; ++i) {
+        sf::Uint32 current = string[i];
+        if (current == L'\r') {
+          characters.push_back(state);
+          continue;
+        }
+        state.x += style.font->getKerning(previous, current, style.size, style.isBold);
+        previous = current;
+
+        if (current == L' ' || current == L'\n' || current == L'\t') {
+          state.minX = std::min(state.minX, state.x);
+          state.minY = std::min(state.minY, 0.0f);
+          if (current == L' ') {
+            state.x += style.whitespaceWidth;
+          } else if (current == L'\t') {
+            state.x += style.whitespaceWidth * 4.0f;
+          }
+          // A newline keeps the width of its line in x. 
+          state.maxX = std::max(state.maxX, current == L'\n' ? 0.0f : state.x);
+          state.maxY = std::max(state.maxY, current == L'\n' ? style.lineSpacing : 0.0f);
+          characters.push_back(state);
+          if (current == L'\n' && !(terminated && i + 1 == newStop)) {
+            lines.push_back({ i + 1, firstQuad + fill.size() / 6 });
+            y += style.lineSpacing;
+            state = { 0.0f, 0, FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX };
+          }
+          continue;
+        }
+
+        if (style.outlineThickness != 0.0f) {
+          const sf::Glyph& glyph = style.font->getGlyph(current, style.size, style.isBold, style.outlineThickness);
+          addGlyph(outline, Vec2f(state.x, y), glyph, style.italicShear, outlineColor);
+        }
+        const sf::Glyph& glyph = style.font->getGlyph(current, style.size, style.isBold);
+        addGlyph(fill, Vec2f(state.x, y), glyph, style.italicShear, fillColor);
+        float top = glyph.bounds.top, bottom = glyph.bounds.top + glyph.bounds.height;
+        state.minX = std::min(state.minX, state.x + glyph.bounds.left - style.italicShear * bottom);
+        state.maxX = std::max(state.maxX, state.x + glyph.bounds.left + glyph.bounds.width - style.italicShear * top);
+        state.minY = std::min(state.minY, top);
+        state.maxY = std::max(state.maxY, bottom);
+        state.x += glyph.advance + style.letterSpacing;
+        ++state.quadEnd;
+        characters.push_back(state);
+      }
+
+      // Swap the new run in for the old one. 
+      layout.vertices.resize(layout.glyphQuadCount * 6);
+      layout.outlineVertices.resize(style.outlineThickness != 0.0f ? layout.glyphQuadCount * 6 : 0);
+      layout.characters.erase(layout.characters.begin() + first, layout.characters.begin() + oldStop);
+      layout.characters.insert(layout.characters.begin() + first, characters.begin(), characters.end());
+      layout.vertices.erase(layout.vertices.begin() + firstQuad * 6, layout.vertices.begin() + oldQuadStop * 6);
+      layout.vertices.insert(layout.vertices.begin() + firstQuad * 6, fill.begin(), fill.end());
+      if (style.outlineThickness != 0.0f) {
+        layout.outlineVertices.erase(layout.outlineVertices.begin() + firstQuad * 6,
+          layout.outlineVertices.begin() + oldQuadStop * 6);
+        layout.outlineVertices.insert(layout.outlineVertices.begin() + firstQuad * 6, outline.begin(), outline.end());
+      }
+      size_t newQuadStop = firstQuad + fill.size() / 6;
+      layout.glyphQuadCount = layout.glyphQuadCount + newQuadStop - oldQuadStop;
+
+      // Lines after the run only move. 
+      ptrdiff_t lineShift = static_cast<ptrdiff_t>(lines.size()) - static_cast<ptrdiff_t>(firstKept - line - 1);
+      layout.lines.erase(layout.lines.begin() + line + 1, layout.lines.begin() + firstKept);
+      layout.lines.insert(layout.lines.begin() + line + 1, lines.begin(), lines.end());
+      for (size_t i = line + 1 + lines.size(); i < layout.lines.size(); ++i) {
+        layout.lines[i].firstCharacter = layout.lines[i].firstCharacter + newStop - oldStop;
+        layout.lines[i].firstQuad = layout.lines[i].firstQuad + newQuadStop - oldQuadStop;
+      }
+      if (lineShift != 0) {
+        // Italic glyphs lean from the baseline so moving down also moves left. 
+        sf::Vector2f offset(-style.italicShear * lineShift * style.lineSpacing, lineShift * style.lineSpacing);
+        for (size_t i = newQuadStop * 6; i < layout.glyphQuadCount * 6; ++i) {
+          layout.vertices[i].position += offset;
+          if (style.outlineThickness != 0.0f) {
+            layout.outlineVertices[i].position += offset;
+          }
+        }
+      }
+
+      finishLayout(layout, style, length, fillColor, outlineColor);
+    }
+
+    std::shared_ptr<const TextLayout> layoutText(const sf::Text& text) {
+      LayoutKey key = makeLayoutKey(text);
+      std::lock_guard<std::mutex> lock(layoutMutex);
+      if (std::shared_ptr<const TextLayout>* found = layoutCache.find(key)) {
+        return *found;
+      }
+      // Laid out while holding the lock too since loading glyphs changes the 
+      // font. 
+      auto layout = std::make_shared<TextLayout>();
+      relayoutText(*layout, text, 0, 0, text.getString().getSize(), key.fillColor, key.outlineColor);
+      return layoutCache.insert(key, std::move(layout));
+    }
+  }
+
+  Text::Text()
+    : shadow(false), shadowOffset(1.0f, 1.0f), shadowColor(0, 0, 0, 128) {
     locked = false;
   }
 
@@ -15,18 +363,51 @@ namespace gs {
   }
 
   void Text::render(sf::RenderTarget* target, sf::RenderStates renderStates) {
+    if (text.getFont() == nullptr || text.getString().isEmpty()) return;
+    // The cached layout is drawn instead of text so SFML never lays the 
+    // string out again. 
+    const priv::TextLayout& glyphs = getLayout();
+    renderStates.texture = &text.getFont()->getTexture(text.getCharacterSize());
+    if (shadow) {
+      updateShadow();
+      sf::RenderStates shadowStates = renderStates;
+      shadowStates.transform.translate(sf::Vector2f(shadowOffset.x, shadowOffset.y));
+      shadowStates.transform *= text.getTransform();
+      if (!glyphs.outlineVertices.empty()) {
+        target->draw(glyphs.outlineVertices.data(), glyphs.outlineVertices.size(), sf::Triangles, shadowStates);
+      }
+      if (!shadowVertices.empty()) {
+        target->draw(shadowVertices.data(), shadowVertices.size(), sf::Triangles, shadowStates);
+      }
+    }
+    renderStates.transform *= text.getTransform();
+    if (!glyphs.outlineVertices.empty()) {
+      target->draw(glyphs.outlineVertices.data(), glyphs.outlineVertices.size(), sf::Triangles, renderStates);
+    }
+    if (!glyphs.vertices.empty()) {
+      target->draw(glyphs.vertices.data(), glyphs.vertices.size(), sf::Triangles, renderStates);
+    }
+  }
+
+  void Text::batch(RenderBatch& batch) {
+    if (text.getFont() == nullptr || text.getString().isEmpty()) return;
+    const priv::TextLayout& glyphs = getLayout();
     if (shadow) {
-      sf::Text shadowText = text;
-      shadowText.setPosition(text.getPosition() + sf::Vector2f(shadowOffset.x, shadowOffset.y));
-      shadowText.setFillColor(sf::Color(shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a));
-      target->draw(shadowText, renderStates);
+      updateShadow();
+      sf::Transform transform;
+      transform.translate(sf::Vector2f(shadowOffset.x, shadowOffset.y));
+      transform *= text.getTransform();
+      addGlyphs(batch, transform, glyphs.outlineVertices);
+      addGlyphs(batch, transform, shadowVertices);
     }
-    target->draw(text, renderStates);
+    addGlyphs(batch, text.getTransform(), glyphs.outlineVertices);
+    addGlyphs(batch, text.getTransform(), glyphs.vertices);
   }
 
   void Text::setPosition(Vec2f position) {
     text.setPosition(sf::Vector2f(position.x, position.y));
-    generateHitbox();
+    hitbox.setPosition(position);
+    markDirty(Dirty::Transform);
   }
 
   void Text::setPosition(float xpos, float ypos) {
@@ -34,7 +415,7 @@ namespace gs {
   }
 
   void Text::setCenter(Vec2f position) {
-    sf::FloatRect bounds = text.getLocalBounds();
+    const sf::FloatRect& bounds = getLocalBounds();
     setPosition(position.x - bounds.width / 2, position.y - bounds.height / 2);
   }
 
@@ -44,7 +425,8 @@ namespace gs {
 
   void Text::move(Vec2f offset) {
     text.move(sf::Vector2f(offset.x, offset.y));
-    generateHitbox();
+    hitbox.move(offset);
+    markDirty(Dirty::Transform);
   }
 
   void Text::move(float offsetx, float offsety) {
@@ -52,7 +434,7 @@ namespace gs {
   }
 
   void Text::applyStyle(const Style& style) {
-    this->style = style;
+    Component::applyStyle(style);
     setFillColor(style.fillColor);
     setOutlineColor(style.outlineColor);
     setOutlineThickness(style.outlineThickness);
@@ -69,7 +451,7 @@ namespace gs {
 
   void Text::setScale(Vec2f scalar) {
     text.setScale(sf::Vector2f(scalar.x, scalar.y));
-    generateHitbox();
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
   }
 
   void Text::setScale(float scalex, float scaley) {
@@ -78,33 +460,77 @@ namespace gs {
 
   void Text::setFont(const sf::Font& font) {
     text.setFont(font);
-    generateHitbox();
+    invalidateLayout();
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
   }
 
   void Text::setString(const std::string& string) {
     text.setString(string);
-    generateHitbox();
+    invalidateLayout();
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
+  }
+
+  void Text::insertString(size_t position, const std::string& string) {
+    sf::String inserted(string);
+    sf::String updated = text.getString();
+    updated.insert(position, inserted);
+    text.setString(updated);
+    if (layout) {
+      priv::relayoutText(editLayout(), text, position, position, position + inserted.getSize(),
+        text.getFillColor(), text.getOutlineColor());
+      shadowStale = true;
+    }
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
+  }
+
+  void Text::eraseString(size_t position, size_t count) {
+    sf::String updated = text.getString();
+    updated.erase(position, count);
+    text.setString(updated);
+    if (layout) {
+      priv::relayoutText(editLayout(), text, position, position + count, position,
+        text.getFillColor(), text.getOutlineColor());
+      shadowStale = true;
+    }
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
   }
 
   void Text::setFillColor(Color color) {
     text.setFillColor(sf::Color(color.r, color.g, color.b, color.a));
+    // A shared layout is found again in the new color. One edited by this 
+    // Text is its own so it is recolored in place. 
+    if (editedLayout) {
+      recolor(false);
+    } else {
+      layout.reset();
+    }
+    markDirty(Dirty::Style);
   }
 
   void Text::setOutlineThickness(float thickness) {
     text.setOutlineThickness(thickness);
-    generateHitbox();
+    invalidateLayout();
+    markDirty(Dirty::Geometry | Dirty::Hitbox);
   }
 
   void Text::setOutlineColor(Color outlineColor) {
     text.setOutlineColor(sf::Color(outlineColor.r, outlineColor.g, outlineColor.b, outlineColor.a));
+    if (editedLayout) {
+      recolor(true);
+    } else {
+      layout.reset();
+    }
+    markDirty(Dirty::Style);
   }
 
   void Text::setShadow(bool hasShadow) {
     shadow = hasShadow;
+    markDirty(Dirty::Style);
   }
 
   void Text::setShadowOffset(Vec2f offset) {
     shadowOffset = offset;
+    markDirty(Dirty::Style);
   }
 
   void Text::setShadowOffset(float offsetx, float offsety) {
@@ -113,6 +539,8 @@ namespace gs {
 
   void Text::setShadowColor(Color shadowColor) {
     this->shadowColor = shadowColor;
+    shadowStale = true;
+    markDirty(Dirty::Style);
   }
 
   Vec2f Text::getPosition() const {
@@ -121,12 +549,13 @@ namespace gs {
   }
 
   Vec2f Text::getCenter() const {
-    sf::FloatRect bounds = text.getLocalBounds();
+    const sf::FloatRect& bounds = getLocalBounds();
     sf::Vector2f pos = text.getPosition();
     return Vec2f(pos.x + bounds.width / 2, pos.y + bounds.height / 2);
   }
 
   const Hitbox& Text::getHitbox() const {
+    getLocalBounds();
     return hitbox;
   }
 
@@ -178,16 +607,110 @@ namespace gs {
   }
 
   sf::Text& Text::getText() {
+    invalidateLayout();
     return text;
   }
 
+  Vec2f Text::findCharacterPos(size_t index) const {
+    if (text.getFont() == nullptr) return getPosition();
+    const priv::TextLayout& glyphs = getLayout();
+    index = std::min(index, glyphs.characters.size());
+    size_t line = std::upper_bound(glyphs.lines.begin() + 1, glyphs.lines.end(), index,
+      [](size_t index, const priv::TextLayout::Line& other) { return index < other.firstCharacter; }
+    ) - glyphs.lines.begin() - 1;
+    // Characters keep the pen position after them. 
+    float x = index > glyphs.lines[line].firstCharacter ? glyphs.characters[index - 1].x : 0.0f;
+    float lineSpacing = text.getFont()->getLineSpacing(text.getCharacterSize()) * text.getLineSpacing();
+    sf::Vector2f position = text.getTransform().transformPoint(x, line * lineSpacing);
+    return Vec2f(position.x, position.y);
+  }
+
+  float Text::getLineHeight() const {
+    if (text.getFont() == nullptr) return 0.0f;
+    return text.getFont()->getLineSpacing(text.getCharacterSize()) * text.getLineSpacing() * text.getScale().y;
+  }
+
   void Text::generateHitbox() {
-    sf::FloatRect bounds = text.getLocalBounds();
-    sf::Vector2f position = text.getPosition();
-    Hitbox result = Hitbox(Hitbox::Shape::Rectangle);
-    result.setPosition(position);
-    result.setSize(bounds.getSize());
-    hitbox = result;
+    markDirty(Dirty::Hitbox);
+    getLocalBounds();
+  }
+
+  const sf::FloatRect& Text::getLocalBounds() const {
+    // The bounds come from the shared layout so a string that was shown 
+    // before isn't measured again.
+    if (isDirty(Dirty::Hitbox)) {
+      localBounds = getLayout().localBounds;
+      Hitbox result = Hitbox(Hitbox::Shape::Rectangle);
+      result.setPosition(text.getPosition());
+      result.setSize(localBounds.getSize());
+      hitbox = result;
+      clearDirty(Dirty::Hitbox);
+    }
+    return localBounds;
+  }
+
+  void Text::setLayoutCacheCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(layoutMutex);
+    layoutCache.setCapacity(capacity);
+  }
+
+  void Text::clearLayoutCache() {
+    std::lock_guard<std::mutex> lock(layoutMutex);
+    layoutCache.clear();
+  }
+
+  const priv::TextLayout& Text::getLayout() const {
+    if (!layout) {
+      layout = priv::layoutText(text);
+    }
+    return *layout;
+  }
+
+  priv::TextLayout& Text::editLayout() {
+    // Copied the first time it is edited. Later edits change the copy. 
+    if (!editedLayout) {
+      editedLayout = std::make_shared<priv::TextLayout>(getLayout());
+      layout = editedLayout;
+    }
+    return *editedLayout;
+  }
+
+  void Text::invalidateLayout() {
+    layout.reset();
+    editedLayout.reset();
+    shadowStale = true;
+  }
+
+  void Text::recolor(bool outline) {
+    vector<sf::Vertex>& vertices = outline ? editedLayout->outlineVertices : editedLayout->vertices;
+    sf::Color color = outline ? text.getOutlineColor() : text.getFillColor();
+    for (sf::Vertex& vertex : vertices) {
+      vertex.color = color;
+    }
+  }
+
+  void Text::updateShadow() {
+    if (!shadowStale) return;
+    shadowStale = false;
+    const priv::TextLayout& glyphs = getLayout();
+    sf::Color color(shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
+    shadowVertices.resize(glyphs.vertices.size());
+    for (size_t i = 0; i < glyphs.vertices.size(); ++i) {
+      shadowVertices[i] = glyphs.vertices[i];
+      shadowVertices[i].color = color;
+    }
+  }
+
+  void Text::addGlyphs(RenderBatch& batch, const sf::Transform& transform,
+    const vector<sf::Vertex>& source) {
+    if (source.empty()) return;
+    // Only looked up now since loading glyphs can grow the page. 
+    const sf::Texture* texture = &text.getFont()->getTexture(text.getCharacterSize());
+    sf::Vertex* output = batch.addTriangles(source.size(), transform.transformRect(getLayout().quadBounds), texture);
+    for (size_t i = 0; i < source.size(); ++i) {
+      output[i] = source[i];
+      output[i].position = transform.transformPoint(source[i].position);
+    }
   }
 
   void draw(sf::RenderTarget* target, Text& text, sf::RenderStates renderStates) {
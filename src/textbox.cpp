@@ -1,6 +1,8 @@
 #include "textbox.hpp"
 #include "input/key.hpp"
 #include <SFML/Window/Keyboard.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace gs {
   Textbox::Textbox() : Button() {
@@ -17,35 +19,97 @@ namespace gs {
     if (isActive && inputMethod == InputMethod::Keyboard) {
       sf::String textString(input::textUnicode);
       std::string input = textString.toAnsiString();
-      if (!input.empty() && storedString.length() < maxLength) {
+      size_t selected = getSelectionEnd() - getSelectionStart();
+      if (!input.empty() && buffer.size() - selected < maxLength) {
         if (validInputs == ValidInputs::Alpha && std::isalpha(input[0])) {
-          storedString += input;
+          insertAtCursor(input);
         } else if (validInputs == ValidInputs::Numeric && std::isdigit(input[0])) {
-          storedString += input;
+          insertAtCursor(input);
         } else if (validInputs == ValidInputs::AlphaNumeric && std::isalnum(input[0])) {
-          storedString += input;
+          insertAtCursor(input);
         }
       }
 
-      // Handle backspace
-      if (sf::Keyboard::isKeyPressed(sf::Keyboard::BackSpace) && !storedString.empty()) {
-        storedString.pop_back();
+      // Handle editing and cursor keys. They repeat while held. 
+      bool select = input::keyShift;
+      switch (input::keyPressed) {
+        case sf::Keyboard::Backspace:
+          eraseAtCursor(false);
+          break;
+        case sf::Keyboard::Delete:
+          eraseAtCursor(true);
+          break;
+        case sf::Keyboard::Left:
+          // Without shift the selection collapses to its start. 
+          if (!select && cursor != selectionAnchor) {
+            setCursor(getSelectionStart());
+          } else if (cursor > 0) {
+            setCursor(cursor - 1, select);
+          }
+          break;
+        case sf::Keyboard::Right:
+          if (!select && cursor != selectionAnchor) {
+            setCursor(getSelectionEnd());
+          } else {
+            setCursor(cursor + 1, select);
+          }
+          break;
+        case sf::Keyboard::Home:
+          setCursor(0, select);
+          break;
+        case sf::Keyboard::End:
+          setCursor(buffer.size(), select);
+          break;
+        default:
+          break;
       }
-
-      // Update text display
-      updateTextDisplay();
     }
 
     // Handle cursor blinking
-    static int tickCount = 0;
-    if (++tickCount >= cursorTickSpeed) {
+    if (isActive && ++tickCount >= cursorTickSpeed) {
       tickCount = 0;
-      // Toggle cursor visibility
+      cursorVisible = !cursorVisible;
+      markDirty(Dirty::Style);
+    }
+  }
+
+  void Textbox::render(sf::RenderTarget* target, sf::RenderStates renderStates) {
+    Button::render(target, renderStates);
+    findSelectionRects();
+    for (const sf::FloatRect& rect : selectionRects) {
+      sf::RectangleShape shape(rect.getSize());
+      shape.setPosition(rect.getPosition());
+      shape.setFillColor(selectionColor);
+      target->draw(shape, renderStates);
+    }
+    sf::FloatRect cursorRect;
+    if (findCursorRect(cursorRect)) {
+      sf::RectangleShape shape(cursorRect.getSize());
+      shape.setPosition(cursorRect.getPosition());
+      shape.setFillColor(cursorColor);
+      target->draw(shape, renderStates);
+    }
+  }
+
+  void Textbox::batch(RenderBatch& batch) {
+    Button::batch(batch);
+    findSelectionRects();
+    for (const sf::FloatRect& rect : selectionRects) {
+      batch.addRectangle(rect.getPosition(), rect.getSize(), selectionColor);
+    }
+    sf::FloatRect cursorRect;
+    if (findCursorRect(cursorRect)) {
+      batch.addRectangle(cursorRect.getPosition(), cursorRect.getSize(), cursorColor);
     }
   }
 
   void Textbox::setStoredString(const std::string& string) {
+    buffer.clear();
+    buffer.insert(0, string.data(), string.length());
     storedString = string;
+    storedStringStale = false;
+    cursor = selectionAnchor = buffer.size();
+    resetBlink();
     updateTextDisplay();
   }
 
@@ -64,9 +128,65 @@ namespace gs {
 
   void Textbox::setActive(bool active) {
     isActive = active;
+    resetBlink();
+  }
+
+  void Textbox::setCursor(size_t position, bool select) {
+    cursor = std::min(position, buffer.size());
+    if (!select) {
+      selectionAnchor = cursor;
+    }
+    // The next edit is most likely here. 
+    buffer.moveGap(cursor);
+    resetBlink();
+  }
+
+  void Textbox::selectAll() {
+    selectionAnchor = 0;
+    cursor = buffer.size();
+    resetBlink();
+  }
+
+  void Textbox::insertAtCursor(const std::string& string) {
+    size_t first = getSelectionStart(), last = getSelectionEnd();
+    size_t room = maxLength - std::min(maxLength, buffer.size() - (last - first));
+    if (string.length() > room) {
+      replaceRange(first, last, string.substr(0, room));
+    } else {
+      replaceRange(first, last, string);
+    }
+  }
+
+  void Textbox::eraseAtCursor(bool forward) {
+    size_t first = getSelectionStart(), last = getSelectionEnd();
+    if (first == last) {
+      if (forward && last < buffer.size()) {
+        ++last;
+      } else if (!forward && first > 0) {
+        --first;
+      } else {
+        return;
+      }
+    }
+    replaceRange(first, last, "");
+  }
+
+  void Textbox::setCursorColor(Color color) {
+    cursorColor = color;
+    markDirty(Dirty::Style);
+  }
+
+  void Textbox::setSelectionColor(Color color) {
+    selectionColor = color;
+    markDirty(Dirty::Style);
   }
 
   const std::string& Textbox::getStoredString() const {
+    if (storedStringStale) {
+      storedString.resize(buffer.size());
+      buffer.copyOut(&storedString[0], 0, buffer.size());
+      storedStringStale = false;
+    }
     return storedString;
   }
 
@@ -86,7 +206,92 @@ namespace gs {
     return isActive;
   }
 
-  // Protected helper method
+  size_t Textbox::getCursor() const {
+    return cursor;
+  }
+
+  size_t Textbox::getSelectionStart() const {
+    return std::min(cursor, selectionAnchor);
+  }
+
+  size_t Textbox::getSelectionEnd() const {
+    return std::max(cursor, selectionAnchor);
+  }
+
+  Color Textbox::getCursorColor() const {
+    return cursorColor;
+  }
+
+  Color Textbox::getSelectionColor() const {
+    return selectionColor;
+  }
+
+  // Protected helper methods
+  bool Textbox::showsStoredString() const {
+    return textRenderMethod == TextRenderMethod::StoredValue ||
+      (textRenderMethod == TextRenderMethod::MessageAndStoredValue && !buffer.empty());
+  }
+
+  void Textbox::replaceRange(size_t first, size_t last, const std::string& string) {
+    if (first == last && string.empty()) return;
+    bool wasShown = showsStoredString();
+    buffer.erase(first, last - first);
+    buffer.insert(first, string.data(), string.length());
+    storedStringStale = true;
+    cursor = selectionAnchor = first + string.length();
+    resetBlink();
+
+    if (!wasShown || !showsStoredString()) {
+      updateTextDisplay();
+      return;
+    }
+    if (last > first) {
+      Button::eraseString(first, last - first);
+    }
+    if (!string.empty()) {
+      Button::insertString(first, string);
+    }
+  }
+
+  void Textbox::resetBlink() {
+    tickCount = 0;
+    cursorVisible = true;
+    markDirty(Dirty::Style);
+  }
+
+  void Textbox::findSelectionRects() {
+    selectionRects.clear();
+    size_t first = getSelectionStart(), last = getSelectionEnd();
+    if (first == last || !showsStoredString()) return;
+    // One rectangle per line the selection covers. 
+    float height = text.getLineHeight();
+    while (first < last) {
+      size_t end = first;
+      while (end < last && buffer[end] != '\n') {
+        ++end;
+      }
+      Vec2f left = text.findCharacterPos(first), right = text.findCharacterPos(end);
+      if (right.x > left.x) {
+        selectionRects.emplace_back(left.x, left.y, right.x - left.x, height);
+      }
+      first = end + 1;
+    }
+  }
+
+  bool Textbox::findCursorRect(sf::FloatRect& rect) const {
+    if (!isActive || !cursorVisible) return false;
+    if (textRenderMethod != TextRenderMethod::StoredValue &&
+      textRenderMethod != TextRenderMethod::MessageAndStoredValue) {
+      return false;
+    }
+    // Before anything is typed the message is shown so the cursor sits at 
+    // its start. 
+    Vec2f position = text.findCharacterPos(showsStoredString() ? cursor : 0);
+    float height = text.getLineHeight();
+    rect = sf::FloatRect(position.x, position.y, std::max(1.0f, std::floor(height / 16.0f)), height);
+    return true;
+  }
+
   void Textbox::updateTextDisplay() {
     std::string displayText;
     switch (textRenderMethod) {
@@ -97,13 +302,14 @@ namespace gs {
         displayText = defaultMessage;
         break;
       case TextRenderMethod::StoredValue:
-        displayText = storedString;
+        displayText = getStoredString();
         break;
       case TextRenderMethod::MessageAndStoredValue:
-        displayText = storedString.empty() ? defaultMessage : storedString;
+        displayText = buffer.empty() ? defaultMessage : getStoredString();
         break;
     }
     
-    Button::setString(displayText); // Assuming Button has a setString method
+    Button::setString(displayText);
+    markDirty(Dirty::Geometry);
   }
 }
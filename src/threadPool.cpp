@@ -0,0 +1,160 @@
+#include "threadPool.hpp"
+#include <algorithm>
+
+namespace gs {
+  namespace priv {
+
+    namespace {
+      uint64_t pack(uint32_t begin, uint32_t end) {
+        return (static_cast<uint64_t>(end) << 32) | begin;
+      }
+
+      void unpack(uint64_t bounds, uint32_t& begin, uint32_t& end) {
+        begin = static_cast<uint32_t>(bounds);
+        end = static_cast<uint32_t>(bounds >> 32);
+      }
+    }
+
+    ThreadPool::ThreadPool(size_t threadCount) {
+      if (threadCount == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores - 1 : 0;
+      }
+      ranges = std::make_unique<Range[]>(threadCount + 1);
+      threads.reserve(threadCount);
+      for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+      }
+    }
+
+    ThreadPool::~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      loopStarted.notify_all();
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    }
+
+    void ThreadPool::parallelFor(size_t count, size_t grainSize,
+      const std::function<void(size_t)>& task) {
+      grainSize = std::max<size_t>(grainSize, 1);
+      bool expected = false;
+      if (threads.empty() || count <= grainSize || count > UINT32_MAX ||
+        !busy.compare_exchange_strong(expected, true)) {
+        for (size_t i = 0; i < count; ++i) {
+          task(i);
+        }
+        return;
+      }
+
+      // Every thread starts with an equal contiguous share.
+      size_t shares = threads.size() + 1;
+      for (size_t i = 0; i < shares; ++i) {
+        uint32_t begin = static_cast<uint32_t>(count * i / shares);
+        uint32_t end = static_cast<uint32_t>(count * (i + 1) / shares);
+        ranges[i].bounds.store(pack(begin, end), std::memory_order_relaxed);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->grainSize = grainSize;
+        runningWorkers = threads.size();
+        ++loopId;
+      }
+      loopStarted.notify_all();
+
+      runRanges(0);
+
+      std::unique_lock<std::mutex> lock(mutex);
+      loopFinished.wait(lock, [this] { return runningWorkers == 0; });
+      this->task = nullptr;
+      busy.store(false);
+    }
+
+    size_t ThreadPool::getThreadCount() const {
+      return threads.size();
+    }
+
+    ThreadPool& ThreadPool::getDefault() {
+      static ThreadPool pool;
+      return pool;
+    }
+
+    void ThreadPool::workerLoop(size_t index) {
+      uint64_t seenLoop = 0;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          loopStarted.wait(lock, [this, seenLoop] { return stopping || loopId != seenLoop; });
+          if (stopping) return;
+          seenLoop = loopId;
+        }
+
+        runRanges(index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--runningWorkers == 0) {
+          loopFinished.notify_one();
+        }
+      }
+    }
+
+    void ThreadPool::runRanges(size_t index) {
+      size_t shares = threads.size() + 1;
+      Range& own = ranges[index];
+      uint32_t begin, end;
+      while (true) {
+        while (takeFront(own, begin, end)) {
+          for (uint32_t i = begin; i < end; ++i) {
+            (*task)(i);
+          }
+        }
+
+        // Out of work, look for a thread that still has some.
+        bool stole = false;
+        for (size_t offset = 1; offset < shares && !stole; ++offset) {
+          stole = stealBack(ranges[(index + offset) % shares], begin, end);
+        }
+        if (!stole) return;
+        // Only this thread writes to an empty Range so it can be refilled
+        // directly. Thieves never touch it while it is empty.
+        own.bounds.store(pack(begin, end));
+      }
+    }
+
+    bool ThreadPool::takeFront(Range& range, uint32_t& begin, uint32_t& end) {
+      uint64_t bounds = range.bounds.load();
+      while (true) {
+        uint32_t first, last;
+        unpack(bounds, first, last);
+        if (first >= last) return false;
+        uint32_t next = static_cast<uint32_t>(std::min<size_t>(first + grainSize, last));
+        if (range.bounds.compare_exchange_weak(bounds, pack(next, last))) {
+          begin = first;
+          end = next;
+          return true;
+        }
+      }
+    }
+
+    bool ThreadPool::stealBack(Range& range, uint32_t& begin, uint32_t& end) {
+      uint64_t bounds = range.bounds.load();
+      while (true) {
+        uint32_t first, last;
+        unpack(bounds, first, last);
+        if (first >= last) return false;
+        uint32_t middle = first + (last - first) / 2;
+        if (range.bounds.compare_exchange_weak(bounds, pack(first, middle))) {
+          begin = middle;
+          end = last;
+          return true;
+        }
+      }
+    }
+
+  }
+}
@@ -0,0 +1,322 @@
+#include "timeSeries.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace gs {
+
+  namespace {
+    /// Number of blocks of a level merged into one block of the next.
+    const size_t pyramidFanout = 16;
+    /// Identifies a finished sidecar file. Written last so a sidecar left
+    /// behind by an interrupted build is never used.
+    const char pyramidMagic[8] = { 'G', 'S', 'P', 'Y', 'R', 'M', 'D', '1' };
+    /// Most samples read for one column while there is no pyramid. 
+    const size_t maxSamplesPerColumn = 256;
+
+    struct PyramidHeader {
+      char magic[8];
+      uint32_t format;
+      uint32_t fanout;
+      uint64_t sourceSize;
+      int64_t sourceVersion;
+    };
+  }
+
+  TimeSeriesFile::TimeSeriesFile() = default;
+
+  TimeSeriesFile::~TimeSeriesFile() {
+    close();
+  }
+
+  bool TimeSeriesFile::open(const std::string& path, Format format) {
+    close();
+    if (!source.open(path)) return false;
+    this->path = path;
+    this->format = format;
+    recordSize = format == Format::Float32 ? sizeof(float) : sizeof(int64_t) + sizeof(float);
+    sampleCount = static_cast<size_t>(source.getSize() / recordSize);
+    return true;
+  }
+
+  void TimeSeriesFile::close() {
+    if (pyramidThread.joinable()) {
+      cancelPyramid = true;
+      pyramidThread.join();
+      cancelPyramid = false;
+    }
+    source.close();
+    pyramid.close();
+    levels.clear();
+    levelSizes.clear();
+    sampleCount = 0;
+    pyramidState = PyramidState::None;
+  }
+
+  bool TimeSeriesFile::buildPyramid() {
+    if (pyramidThread.joinable()) {
+      pyramidThread.join();
+    }
+    if (pyramidState == PyramidState::None && isOpen()) {
+      pyramidState = loadPyramid() ? PyramidState::Ready : PyramidState::Failed;
+    }
+    return pyramidState == PyramidState::Ready;
+  }
+
+  void TimeSeriesFile::startPyramid() {
+    if (pyramidState != PyramidState::None || !isOpen()) return;
+    pyramidState = PyramidState::Building;
+    pyramidThread = std::thread([this]() {
+      pyramidState = loadPyramid() ? PyramidState::Ready : PyramidState::Failed;
+    });
+  }
+
+  bool TimeSeriesFile::loadPyramid() {
+    std::string sidecarPath = path + ".pyramid";
+    int64_t version = getSourceVersion();
+
+    // Reuse the sidecar if it was finished for this version of the capture.
+    if (pyramid.open(sidecarPath) && pyramid.getSize() >= sizeof(PyramidHeader)) {
+      PyramidHeader header;
+      std::memcpy(&header, pyramid.getData(), sizeof(header));
+      if (std::memcmp(header.magic, pyramidMagic, sizeof(pyramidMagic)) == 0 &&
+        header.format == static_cast<uint32_t>(format) && header.fanout == pyramidFanout &&
+        header.sourceSize == source.getSize() && header.sourceVersion == version &&
+        findLevels() == pyramid.getSize()) {
+        return true;
+      }
+    }
+    pyramid.close();
+    levels.clear();
+    levelSizes.clear();
+
+    // Size the sidecar first so every level can be written in place.
+    uint64_t size = sizeof(PyramidHeader);
+    for (size_t blocks = sampleCount; blocks > 1;) {
+      blocks = (blocks + pyramidFanout - 1) / pyramidFanout;
+      size += blocks * sizeof(Extremes);
+    }
+    if (sampleCount < 2 || !pyramid.create(sidecarPath, size)) {
+      pyramid.close();
+      return false;
+    }
+    findLevels();
+
+    // The first level streams through the capture once, every other level
+    // is built from the one before it.
+    Extremes* level = const_cast<Extremes*>(levels[0]);
+    for (size_t block = 0; block < levelSizes[0]; ++block) {
+      // The magic isn't written yet so a cancelled sidecar is rebuilt. 
+      if (block % 65536 == 0 && cancelPyramid) {
+        pyramid.close();
+        levels.clear();
+        levelSizes.clear();
+        return false;
+      }
+      size_t first = block * pyramidFanout;
+      size_t last = std::min(first + pyramidFanout, sampleCount);
+      Extremes extremes = { getValue(first), getValue(first) };
+      for (size_t i = first + 1; i < last; ++i) {
+        float value = getValue(i);
+        extremes.min = std::min(extremes.min, value);
+        extremes.max = std::max(extremes.max, value);
+      }
+      level[block] = extremes;
+    }
+    for (size_t i = 1; i < levels.size(); ++i) {
+      const Extremes* finer = levels[i - 1];
+      Extremes* coarser = const_cast<Extremes*>(levels[i]);
+      for (size_t block = 0; block < levelSizes[i]; ++block) {
+        size_t first = block * pyramidFanout;
+        size_t last = std::min(first + pyramidFanout, levelSizes[i - 1]);
+        Extremes extremes = finer[first];
+        for (size_t j = first + 1; j < last; ++j) {
+          extremes.min = std::min(extremes.min, finer[j].min);
+          extremes.max = std::max(extremes.max, finer[j].max);
+        }
+        coarser[block] = extremes;
+      }
+    }
+
+    PyramidHeader header;
+    header.format = static_cast<uint32_t>(format);
+    header.fanout = pyramidFanout;
+    header.sourceSize = source.getSize();
+    header.sourceVersion = version;
+    std::memcpy(header.magic, pyramidMagic, sizeof(pyramidMagic));
+    std::memcpy(pyramid.getData(), &header, sizeof(header));
+    return true;
+  }
+
+  size_t TimeSeriesFile::findIndex(int64_t time) const {
+    if (format == Format::Float32) {
+      return static_cast<size_t>(std::clamp<int64_t>(time, 0, static_cast<int64_t>(sampleCount)));
+    }
+    size_t low = 0, high = sampleCount;
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (getTime(middle) < time) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low;
+  }
+
+  void TimeSeriesFile::readValues(size_t first, size_t count, float* output) const {
+    if (format == Format::Float32) {
+      std::memcpy(output, source.getData() + first * sizeof(float), count * sizeof(float));
+      return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = getValue(first + i);
+    }
+  }
+
+  void TimeSeriesFile::readEnvelope(size_t first, size_t last, size_t columns, float* output) {
+    if (columns == 0) return;
+    last = std::min(last, sampleCount);
+    double perColumn = static_cast<double>(last - std::min(first, last)) / columns;
+
+    // Use the coarsest level that still has at least two blocks per column.
+    // The pyramid is never waited for here since building it reads the 
+    // whole capture. 
+    bool usePyramid = false;
+    if (perColumn >= 2.0 * pyramidFanout) {
+      startPyramid();
+      usePyramid = hasPyramid();
+    }
+    size_t level = 0;
+    while (usePyramid && level + 1 < levels.size() && getBlockSize(level + 1) * 2 <= perColumn) {
+      ++level;
+    }
+
+    for (size_t column = 0; column < columns; ++column) {
+      size_t begin = first + static_cast<size_t>(column * perColumn);
+      size_t end = std::min(last, first + static_cast<size_t>((column + 1) * perColumn));
+      end = std::max(end, std::min(begin + 1, last));
+      float min = 0.0f, max = 0.0f;
+      if (begin >= end) {
+        // Past the end of the capture.
+      } else if (!usePyramid && end - begin > maxSamplesPerColumn) {
+        // No pyramid yet so the column is estimated from evenly spaced 
+        // samples instead of reading all of them. 
+        double step = static_cast<double>(end - 1 - begin) / (maxSamplesPerColumn - 1);
+        min = max = getValue(begin);
+        for (size_t i = 1; i < maxSamplesPerColumn; ++i) {
+          float value = getValue(begin + static_cast<size_t>(i * step));
+          min = std::min(min, value);
+          max = std::max(max, value);
+        }
+      } else {
+        Extremes extremes = findExtremes(begin, end, usePyramid ? level + 1 : 0);
+        min = extremes.min;
+        max = extremes.max;
+      }
+      output[column * 2] = min;
+      output[column * 2 + 1] = max;
+    }
+  }
+
+  TimeSeriesFile::Extremes TimeSeriesFile::findExtremes(size_t begin, size_t end, size_t depth) const {
+    if (depth == 0) {
+      Extremes extremes = { getValue(begin), getValue(begin) };
+      for (size_t i = begin + 1; i < end; ++i) {
+        float value = getValue(i);
+        extremes.min = std::min(extremes.min, value);
+        extremes.max = std::max(extremes.max, value);
+      }
+      return extremes;
+    }
+
+    // Whole blocks come from this level. The partial blocks at the edges 
+    // come from finer ones so samples outside [begin, end) are never used. 
+    size_t level = depth - 1;
+    size_t blockSize = getBlockSize(level);
+    size_t firstBlock = (begin + blockSize - 1) / blockSize;
+    size_t lastBlock = end / blockSize;
+    if (firstBlock >= lastBlock) {
+      return findExtremes(begin, end, level);
+    }
+    Extremes extremes = levels[level][firstBlock];
+    for (size_t block = firstBlock + 1; block < lastBlock; ++block) {
+      extremes.min = std::min(extremes.min, levels[level][block].min);
+      extremes.max = std::max(extremes.max, levels[level][block].max);
+    }
+    if (begin < firstBlock * blockSize) {
+      Extremes edge = findExtremes(begin, firstBlock * blockSize, level);
+      extremes.min = std::min(extremes.min, edge.min);
+      extremes.max = std::max(extremes.max, edge.max);
+    }
+    if (lastBlock * blockSize < end) {
+      Extremes edge = findExtremes(lastBlock * blockSize, end, level);
+      extremes.min = std::min(extremes.min, edge.min);
+      extremes.max = std::max(extremes.max, edge.max);
+    }
+    return extremes;
+  }
+
+  int64_t TimeSeriesFile::getTime(size_t index) const {
+    if (format == Format::Float32) return static_cast<int64_t>(index);
+    int64_t time;
+    std::memcpy(&time, source.getData() + index * recordSize, sizeof(time));
+    return time;
+  }
+
+  float TimeSeriesFile::getValue(size_t index) const {
+    size_t offset = format == Format::Float32 ? 0 : sizeof(int64_t);
+    float value;
+    std::memcpy(&value, source.getData() + index * recordSize + offset, sizeof(value));
+    return value;
+  }
+
+  size_t TimeSeriesFile::getSampleCount() const {
+    return sampleCount;
+  }
+
+  bool TimeSeriesFile::isOpen() const {
+    return source.isOpen();
+  }
+
+  bool TimeSeriesFile::hasPyramid() const {
+    return pyramidState == PyramidState::Ready;
+  }
+
+  size_t TimeSeriesFile::getBlockSize(size_t level) const {
+    size_t blockSize = pyramidFanout;
+    for (size_t i = 0; i < level; ++i) {
+      blockSize *= pyramidFanout;
+    }
+    return blockSize;
+  }
+
+  uint64_t TimeSeriesFile::findLevels() {
+    levels.clear();
+    levelSizes.clear();
+    uint64_t offset = sizeof(PyramidHeader);
+    for (size_t blocks = sampleCount; blocks > 1;) {
+      blocks = (blocks + pyramidFanout - 1) / pyramidFanout;
+      levelSizes.push_back(blocks);
+      offset += blocks * sizeof(Extremes);
+    }
+    if (offset > pyramid.getSize()) {
+      levelSizes.clear();
+      return offset;
+    }
+    offset = sizeof(PyramidHeader);
+    for (size_t blocks : levelSizes) {
+      levels.push_back(reinterpret_cast<const Extremes*>(pyramid.getData() + offset));
+      offset += blocks * sizeof(Extremes);
+    }
+    return offset;
+  }
+
+  int64_t TimeSeriesFile::getSourceVersion() const {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error) return 0;
+    return static_cast<int64_t>(time.time_since_epoch().count());
+  }
+
+}
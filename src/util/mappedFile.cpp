@@ -0,0 +1,160 @@
+#include "util/mappedFile.hpp"
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace gs {
+  namespace util {
+
+    MappedFile::MappedFile() = default;
+
+    MappedFile::~MappedFile() {
+      close();
+    }
+
+  #ifdef _WIN32
+    bool MappedFile::open(const std::string& path) {
+      close();
+      fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+      if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        return false;
+      }
+      LARGE_INTEGER fileSize;
+      if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        close();
+        return false;
+      }
+      size = static_cast<uint64_t>(fileSize.QuadPart);
+      return map(false);
+    }
+
+    bool MappedFile::create(const std::string& path, uint64_t size) {
+      close();
+      fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        return false;
+      }
+      this->size = size;
+      return map(true);
+    }
+
+    bool MappedFile::map(bool writable) {
+      if (size == 0) return true;
+      mappingHandle = CreateFileMappingA(fileHandle, nullptr,
+        writable ? PAGE_READWRITE : PAGE_READONLY,
+        static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+      if (mappingHandle == nullptr) {
+        close();
+        return false;
+      }
+      data = static_cast<char*>(MapViewOfFile(mappingHandle,
+        writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+      if (data == nullptr) {
+        close();
+        return false;
+      }
+      return true;
+    }
+
+    void MappedFile::close() {
+      if (data != nullptr) {
+        UnmapViewOfFile(data);
+      }
+      if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+      }
+      if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+      }
+      data = nullptr;
+      mappingHandle = nullptr;
+      fileHandle = nullptr;
+      size = 0;
+    }
+
+    bool MappedFile::isOpen() const {
+      return fileHandle != nullptr;
+    }
+  #else
+    bool MappedFile::open(const std::string& path) {
+      close();
+      fileDescriptor = ::open(path.c_str(), O_RDONLY);
+      if (fileDescriptor < 0) return false;
+      struct stat status;
+      if (fstat(fileDescriptor, &status) != 0) {
+        close();
+        return false;
+      }
+      size = static_cast<uint64_t>(status.st_size);
+      return map(false);
+    }
+
+    bool MappedFile::create(const std::string& path, uint64_t size) {
+      close();
+      fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fileDescriptor < 0) return false;
+      if (ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0) {
+        close();
+        return false;
+      }
+      this->size = size;
+      return map(true);
+    }
+
+    bool MappedFile::map(bool writable) {
+      // Empty files can't be mapped but are still open.
+      if (size == 0) return true;
+      void* mapping = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+        MAP_SHARED, fileDescriptor, 0);
+      if (mapping == MAP_FAILED) {
+        close();
+        return false;
+      }
+      data = static_cast<char*>(mapping);
+      return true;
+    }
+
+    void MappedFile::close() {
+      if (data != nullptr) {
+        munmap(data, size);
+      }
+      if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+      }
+      data = nullptr;
+      fileDescriptor = -1;
+      size = 0;
+    }
+
+    bool MappedFile::isOpen() const {
+      return fileDescriptor >= 0;
+    }
+  #endif
+
+    const char* MappedFile::getData() const {
+      return data;
+    }
+
+    char* MappedFile::getData() {
+      return data;
+    }
+
+    uint64_t MappedFile::getSize() const {
+      return size;
+    }
+
+  }
+}
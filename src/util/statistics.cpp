@@ -0,0 +1,257 @@
+#include "util/statistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace gs {
+  namespace util {
+
+    namespace {
+      /// Number of blocks the window of a StreamStatistics is split into.
+      const size_t blocksPerWindow = 8;
+      /// Each level of a QuantileSketch below the top holds this much of the
+      /// level above it.
+      const double levelShrink = 2.0 / 3.0;
+    }
+
+    void RunningStats::add(double value) {
+      ++count;
+      double delta = value - mean;
+      mean += delta / count;
+      squaredDistance += delta * (value - mean);
+    }
+
+    void RunningStats::remove(double value) {
+      if (count <= 1) {
+        clear();
+        return;
+      }
+      double delta = value - mean;
+      mean -= delta / (count - 1);
+      --count;
+      // Rounding can leave a tiny negative sum once values cancel out.
+      squaredDistance = std::max(0.0, squaredDistance - delta * (value - mean));
+    }
+
+    void RunningStats::merge(const RunningStats& other) {
+      if (other.count == 0) return;
+      if (count == 0) {
+        *this = other;
+        return;
+      }
+      // Chan's formula for combining two sets.
+      uint64_t total = count + other.count;
+      double delta = other.mean - mean;
+      mean += delta * other.count / total;
+      squaredDistance += other.squaredDistance +
+        delta * delta * (static_cast<double>(count) * other.count / total);
+      count = total;
+    }
+
+    void RunningStats::clear() {
+      count = 0;
+      mean = 0.0;
+      squaredDistance = 0.0;
+    }
+
+    uint64_t RunningStats::getCount() const {
+      return count;
+    }
+
+    double RunningStats::getMean() const {
+      return mean;
+    }
+
+    double RunningStats::getVariance() const {
+      return count > 0 ? squaredDistance / count : 0.0;
+    }
+
+    QuantileSketch::QuantileSketch(size_t accuracy) : accuracy(std::max<size_t>(accuracy, 8)) {}
+
+    void QuantileSketch::add(float value) {
+      if (levels.empty()) {
+        levels.emplace_back();
+      }
+      levels[0].push_back(value);
+      ++count;
+      if (levels[0].size() >= getCapacity(0)) {
+        compact();
+      }
+    }
+
+    void QuantileSketch::merge(const QuantileSketch& other) {
+      if (levels.size() < other.levels.size()) {
+        levels.resize(other.levels.size());
+      }
+      for (size_t level = 0; level < other.levels.size(); ++level) {
+        levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+      }
+      count += other.count;
+      compact();
+    }
+
+    void QuantileSketch::clear() {
+      levels.clear();
+      count = 0;
+    }
+
+    void QuantileSketch::getQuantiles(const double* fractions, float* output, size_t quantileCount) const {
+      vector<std::pair<float, uint64_t>> weighted;
+      uint64_t totalWeight = 0;
+      for (size_t level = 0; level < levels.size(); ++level) {
+        for (float value : levels[level]) {
+          weighted.emplace_back(value, uint64_t(1) << level);
+          totalWeight += uint64_t(1) << level;
+        }
+      }
+      if (weighted.empty()) {
+        std::fill(output, output + quantileCount, 0.0f);
+        return;
+      }
+      std::sort(weighted.begin(), weighted.end());
+
+      // The fractions are increasing so one pass finds all of them.
+      size_t item = 0;
+      uint64_t rank = weighted[0].second;
+      for (size_t i = 0; i < quantileCount; ++i) {
+        double target = fractions[i] * totalWeight;
+        while (rank < target && item + 1 < weighted.size()) {
+          rank += weighted[++item].second;
+        }
+        output[i] = weighted[item].first;
+      }
+    }
+
+    uint64_t QuantileSketch::getCount() const {
+      return count;
+    }
+
+    size_t QuantileSketch::getCapacity(size_t level) const {
+      size_t depth = levels.size() - level - 1;
+      return std::max<size_t>(2, static_cast<size_t>(accuracy * std::pow(levelShrink, depth)));
+    }
+
+    void QuantileSketch::compact() {
+      for (size_t level = 0; level < levels.size(); ++level) {
+        if (levels[level].size() < getCapacity(level)) continue;
+        if (level + 1 == levels.size()) {
+          levels.emplace_back();
+        }
+        vector<float>& values = levels[level];
+        std::sort(values.begin(), values.end());
+
+        // An odd value out stays behind so the weight is kept exactly.
+        float leftover = 0.0f;
+        bool odd = values.size() % 2 == 1;
+        if (odd) {
+          leftover = values.back();
+          values.pop_back();
+        }
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        for (size_t i = seed & 1; i < values.size(); i += 2) {
+          levels[level + 1].push_back(values[i]);
+        }
+        values.clear();
+        if (odd) {
+          values.push_back(leftover);
+        }
+      }
+    }
+
+    StreamStatistics::StreamStatistics(size_t window) {
+      setWindow(window);
+    }
+
+    void StreamStatistics::add(float value) {
+      addToWindow(value);
+      allTimeStats.add(value);
+      allTimeSketch.add(value);
+      allTimeStale = true;
+    }
+
+    void StreamStatistics::add(const float* values, size_t count) {
+      for (size_t i = 0; i < count; ++i) {
+        add(values[i]);
+      }
+    }
+
+    void StreamStatistics::addToWindow(float value) {
+      if (window == 0) return;
+      windowStats.add(value);
+      if (blocks.empty() || blocks.back().count >= blockSize) {
+        blocks.emplace_back();
+      }
+      ++blocks.back().count;
+      blocks.back().sketch.add(value);
+      ++windowCount;
+      // Drop the oldest block once the window is covered without it.
+      while (windowCount - blocks.front().count >= window) {
+        windowCount -= blocks.front().count;
+        blocks.pop_front();
+      }
+      windowStale = true;
+    }
+
+    void StreamStatistics::removeFromWindow(float value) {
+      if (windowStats.getCount() == 0) return;
+      windowStats.remove(value);
+      windowStale = true;
+    }
+
+    void StreamStatistics::setWindow(size_t window) {
+      this->window = window;
+      blockSize = std::max<size_t>((window + blocksPerWindow - 1) / blocksPerWindow, 1);
+      clearWindow();
+    }
+
+    void StreamStatistics::clearWindow() {
+      blocks.clear();
+      windowCount = 0;
+      windowStats.clear();
+      windowStale = true;
+    }
+
+    void StreamStatistics::clear() {
+      clearWindow();
+      allTimeStats.clear();
+      allTimeSketch.clear();
+      allTimeStale = true;
+    }
+
+    const Statistics& StreamStatistics::getWindowStatistics() const {
+      if (windowStale) {
+        QuantileSketch sketch;
+        for (const Block& block : blocks) {
+          sketch.merge(block.sketch);
+        }
+        summarize(windowStats, sketch, windowStatistics);
+        windowStale = false;
+      }
+      return windowStatistics;
+    }
+
+    const Statistics& StreamStatistics::getAllTimeStatistics() const {
+      if (allTimeStale) {
+        summarize(allTimeStats, allTimeSketch, allTimeStatistics);
+        allTimeStale = false;
+      }
+      return allTimeStatistics;
+    }
+
+    void StreamStatistics::summarize(const RunningStats& stats, const QuantileSketch& sketch,
+      Statistics& output) {
+      const double fractions[] = { 0.5, 0.95, 0.99 };
+      float quantiles[3];
+      sketch.getQuantiles(fractions, quantiles, 3);
+      output.count = stats.getCount();
+      output.mean = static_cast<float>(stats.getMean());
+      output.standardDeviation = static_cast<float>(std::sqrt(stats.getVariance()));
+      output.p50 = quantiles[0];
+      output.p95 = quantiles[1];
+      output.p99 = quantiles[2];
+    }
+
+  }
+}
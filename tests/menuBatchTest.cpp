@@ -0,0 +1,54 @@
+#include "Glass/glass.hpp"
+#include <iostream>
+
+namespace {
+  /// Returned when there is no OpenGL context to render with.
+  const int skipped = 77;
+
+  int failures = 0;
+
+  void check(bool condition, const char* message) {
+    if (!condition) {
+      std::cerr << "FAILED: " << message << std::endl;
+      ++failures;
+    }
+  }
+}
+
+int main() {
+  gs::disableDefaultMenu();
+  sf::RenderTexture target;
+  if (!target.create(400, 400)) {
+    std::cerr << "No render target, skipping" << std::endl;
+    return skipped;
+  }
+
+  // Untextured Buttons without a font are plain rectangles so any number 
+  // of them should merge into a single draw call. 
+  const size_t buttonCount = 64;
+  gs::vector<gs::Button> buttons(buttonCount);
+  gs::Menu menu;
+  menu.renderMethod = gs::Menu::RenderMethod::Batched;
+  for (size_t i = 0; i < buttonCount; ++i) {
+    buttons[i].setSize(20.0f, 20.0f);
+    buttons[i].setPosition(static_cast<float>(i % 8) * 25.0f, static_cast<float>(i / 8) * 25.0f);
+    menu.add(&buttons[i]);
+  }
+  menu.render(&target);
+  check(menu.getDrawCallCount() == 1, "Buttons should be drawn in one draw call");
+  check(menu.getFallbackCount() == 0, "Buttons should all be batched");
+
+  // An offset Menu can't be batched so it is rendered on its own and must 
+  // not be counted as a single draw call. 
+  gs::Button nestedButton;
+  nestedButton.setSize(20.0f, 20.0f);
+  gs::Menu nested;
+  nested.add(&nestedButton);
+  nested.setPosition(250.0f, 250.0f);
+  menu.add(&nested);
+  menu.render(&target);
+  check(menu.getDrawCallCount() == 1, "Fallback should not count as a draw call");
+  check(menu.getFallbackCount() == 1, "Offset Menu should be rendered as a fallback");
+
+  return failures == 0 ? 0 : 1;
+}
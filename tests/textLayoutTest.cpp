@@ -0,0 +1,99 @@
+#include "Glass/glass.hpp"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace {
+  /// Returned when the font given can't be loaded.
+  const int skipped = 77;
+  /// Number of random edits made in each style.
+  const int editCount = 2000;
+
+  ///////////////////////////////////////////////////////////
+  /// class EditedText exposes the layout a Text patches in 
+  /// place so it can be compared to a fresh one. Note: 
+  /// getText() would throw the layout away. 
+  ///////////////////////////////////////////////////////////
+  class EditedText : public gs::Text {
+  public:
+    using gs::Text::getLayout;
+
+    const sf::Text& getSfText() const {
+      return text;
+    }
+  };
+
+  bool isClose(float a, float b) {
+    return std::fabs(a - b) < 1e-3f;
+  }
+
+  bool sameVertices(const gs::vector<sf::Vertex>& a, const gs::vector<sf::Vertex>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (!isClose(a[i].position.x, b[i].position.x) || !isClose(a[i].position.y, b[i].position.y) ||
+        a[i].texCoords != b[i].texCoords || a[i].color != b[i].color) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool sameLayout(const gs::priv::TextLayout& edited, const gs::priv::TextLayout& fresh) {
+    if (!sameVertices(edited.vertices, fresh.vertices) ||
+      !sameVertices(edited.outlineVertices, fresh.outlineVertices) ||
+      edited.glyphQuadCount != fresh.glyphQuadCount || edited.lines.size() != fresh.lines.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < edited.lines.size(); ++i) {
+      if (edited.lines[i].firstCharacter != fresh.lines[i].firstCharacter ||
+        edited.lines[i].firstQuad != fresh.lines[i].firstQuad) {
+        return false;
+      }
+    }
+    const sf::FloatRect& a = edited.localBounds;
+    const sf::FloatRect& b = fresh.localBounds;
+    return isClose(a.left, b.left) && isClose(a.top, b.top) && isClose(a.width, b.width) && isClose(a.height, b.height);
+  }
+}
+
+int main(int argc, char** argv) {
+  sf::Font font;
+  if (argc < 2 || !font.loadFromFile(argv[1])) {
+    std::cerr << "No font to lay out with, skipping" << std::endl;
+    return skipped;
+  }
+
+  // Spaces, tabs and newlines take the paths that don't add glyphs. 
+  const char alphabet[] = "abW y\n\tgjQ\r";
+  std::mt19937 random(7);
+  for (int style = 0; style < 4; ++style) {
+    EditedText text;
+    text.setFont(font);
+    text.getText().setStyle(style & 1 ? sf::Text::Underlined | sf::Text::Italic | sf::Text::StrikeThrough : 0);
+    text.setOutlineThickness(style & 2 ? 1.5f : 0.0f);
+    text.setString("");
+    text.getLayout();
+
+    for (int edit = 0; edit < editCount; ++edit) {
+      size_t size = text.getSfText().getString().getSize();
+      if (size > 0 && random() % 3 == 0) {
+        size_t position = random() % size;
+        text.eraseString(position, 1 + random() % std::min<size_t>(size - position, 4));
+      } else {
+        std::string inserted;
+        for (size_t i = 1 + random() % 3; i > 0; --i) {
+          inserted += alphabet[random() % (sizeof(alphabet) - 1)];
+        }
+        text.insertString(random() % 2 ? size : random() % (size + 1), inserted);
+      }
+
+      std::shared_ptr<const gs::priv::TextLayout> fresh = gs::priv::layoutText(text.getSfText());
+      if (!sameLayout(text.getLayout(), *fresh)) {
+        std::cerr << "FAILED: Edited layout differs in style " << style << " after " << edit + 1
+          << " edits" << std::endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}